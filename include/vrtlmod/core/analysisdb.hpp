@@ -0,0 +1,180 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file analysisdb.hpp
+/// @brief Binary analysis database (`*-vrtlmod.db`), a memory-mappable twin of the `*-vrtlmod.xml`
+/// @details The file starts with a Header whose section table points to arrays of fixed-width records. Apart from the
+///          magic, all fields are 32 bit and written little-endian on every host, all sections are 8 byte aligned.
+///          Strings are referenced by their byte offset into the STRINGS section and are NUL-terminated. References to
+///          other records are indices into their section, NONE marks a missing reference. Records of one module (its
+///          cells and variables) are contiguous.
+///          The records only consist of fixed-width integers, so loaders in other languages can mirror them, e.g., the
+///          AnalysisDB class of the generated Python TD module. C++ loaders use View, which reads the records in place
+///          and therefore needs a little-endian host.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRTLMOD_CORE_ANALYSISDB_HPP__
+#define __VRTLMOD_CORE_ANALYSISDB_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace pugi
+{
+class xml_node;
+} // namespace pugi
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief namespace for all core vrtlmod functionalities
+namespace vrtlmod
+{
+////////////////////////////////////////////////////////////////////////////////
+/// @brief namespace for the binary analysis database
+namespace analysisdb
+{
+
+constexpr char MAGIC[8] = { 'V', 'R', 'T', 'L', 'M', 'D', 'B', '\0' };
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t NONE = 0xffffffffu;
+
+inline bool host_is_little_endian(void)
+{
+    const uint32_t probe = 1;
+    return *reinterpret_cast<const unsigned char *>(&probe) == 1;
+}
+
+enum Section : uint32_t
+{
+    STRINGS = 0, ///< char, NUL-terminated strings
+    FILES,       ///< FileRecord
+    MODULES,     ///< ModuleRecord
+    CELLS,       ///< CellRecord
+    VARIABLES,   ///< VariableRecord
+    DIMENSIONS,  ///< DimensionRecord
+    LOCATIONS,   ///< Location, injection locations of variables
+    SECTION_COUNT
+};
+
+struct SectionEntry
+{
+    uint32_t offset_; ///< byte offset from the start of the file
+    uint32_t count_;  ///< number of records (bytes for STRINGS)
+};
+
+struct Header
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t top_cell_; ///< index of the top cell
+    SectionEntry sections_[SECTION_COUNT];
+};
+
+struct Location
+{
+    uint32_t file_; ///< FILES index
+    uint32_t line_;
+    uint32_t column_;
+};
+
+struct FileRecord
+{
+    uint32_t id_;   ///< numeric file id, i.e., `<N>` of `f<N>` in the XML
+    uint32_t path_; ///< string
+};
+
+struct ModuleRecord
+{
+    uint32_t id_; ///< string
+    Location decl_;
+    uint32_t first_cell_;
+    uint32_t cell_count_;
+    uint32_t first_variable_;
+    uint32_t variable_count_;
+};
+
+struct CellRecord
+{
+    uint32_t id_;     ///< string
+    uint32_t type_;   ///< string, id of the instantiated module
+    uint32_t module_; ///< MODULES index of the instantiated module
+    uint32_t parent_; ///< MODULES index of the declaring module, NONE for top cells
+    Location decl_;
+};
+
+enum VariableKind : uint32_t
+{
+    IN = 0,
+    OUT,
+    INOUT,
+    VAR
+};
+
+struct VariableRecord
+{
+    uint32_t id_;       ///< string
+    uint32_t module_;   ///< MODULES index of the declaring module
+    uint32_t kind_;     ///< VariableKind
+    int32_t bits_;      ///< total number of bits
+    uint32_t cxx_type_; ///< string
+    uint32_t bases_;    ///< string, comma separated base types, outermost first
+    uint32_t first_dimension_;
+    uint32_t dimension_count_; ///< outermost first, the last one is the packed element
+    Location decl_;
+    uint32_t first_inj_loc_;
+    uint32_t inj_loc_count_; ///< 0 if the variable is not injectable
+};
+
+struct DimensionRecord
+{
+    int32_t msb_; ///< length - 1 for unpacked dimensions, -1 if unknown
+    int32_t lsb_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class View
+/// @brief Typed access to a database in memory, e.g., a mapped file
+/// @details valid() fails for files of another version and on big-endian hosts
+class View
+{
+    const char *base_;
+
+  public:
+    explicit View(const void *base) : base_(static_cast<const char *>(base)) {}
+    const Header &header(void) const { return *reinterpret_cast<const Header *>(base_); }
+    bool valid(void) const
+    {
+        return host_is_little_endian() && std::memcmp(header().magic_, MAGIC, sizeof(MAGIC)) == 0 &&
+               header().version_ == VERSION;
+    }
+    uint32_t count(Section s) const { return header().sections_[s].count_; }
+    template <typename T> const T *records(Section s) const
+    {
+        return reinterpret_cast<const T *>(base_ + header().sections_[s].offset_);
+    }
+    const char *string(uint32_t ref) const { return base_ + header().sections_[STRINGS].offset_ + ref; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Serialize a VRTL analysis XML (see VrtlmodCore::build_xml()) into a little-endian database
+/// @param root `<vrtlmod_xml>` root node
+std::string serialize(const pugi::xml_node &root);
+
+} // namespace analysisdb
+} // namespace vrtlmod
+
+#endif // __VRTLMOD_CORE_ANALYSISDB_HPP__
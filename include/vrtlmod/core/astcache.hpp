@@ -0,0 +1,92 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file astcache.hpp
+/// @brief In-memory cache of parsed VRTL translation units shared by the vrtlmod stages
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRTLMOD_CORE_ASTCACHE_HPP__
+#define __VRTLMOD_CORE_ASTCACHE_HPP__
+
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Tooling/Tooling.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief namespace for all core vrtlmod functionalities
+namespace vrtlmod
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ASTToolAction
+/// @brief ToolAction that can also act on an already parsed translation unit (TU) taken from an ASTCache
+class ASTToolAction : public clang::tooling::FrontendActionFactory
+{
+  public:
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Run the action on a parsed TU. Must behave as if the TU's main file was parsed by the action itself
+    virtual void run_on_ast(clang::ASTUnit &unit) = 0;
+    virtual ~ASTToolAction(void) {}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ASTCache
+/// @brief Parsed TUs keyed by main file path
+/// @details A TU stays valid as long as none of the files it was built from (main file and all included files)
+///          changed its content. Stale TUs are dropped on lookup.
+class ASTCache
+{
+    struct Entry
+    {
+        std::unique_ptr<clang::ASTUnit> unit_;
+        std::map<std::string, uint64_t> deps_; ///< content hash of every file the TU was built from
+    };
+    std::map<std::string, Entry> entries_;
+    std::map<std::string, uint64_t> hashes_; ///< file content hashes of the current round
+    size_t hits_{ 0 };
+    size_t misses_{ 0 };
+
+    uint64_t get_hash(const std::string &file);
+
+  public:
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Start a new lookup round. Files may have changed since the previous round
+    void begin_round(void) { hashes_.clear(); }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the valid TU of file or nullptr if there is none
+    clang::ASTUnit *get(const std::string &file);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Store a freshly parsed TU of file
+    void store(const std::string &file, std::unique_ptr<clang::ASTUnit> unit);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Number of lookups that returned a cached TU
+    size_t get_hits(void) const { return hits_; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Number of lookups that required (re-)parsing
+    size_t get_misses(void) const { return misses_; }
+
+    ASTCache(void);
+    ~ASTCache(void);
+};
+
+} // namespace vrtlmod
+
+#endif // __VRTLMOD_CORE_ASTCACHE_HPP__
@@ -40,6 +40,7 @@
 #include "vrtlmod/util/logging.hpp"
 #include "vrtlmod/core/filecontext.hpp"
 
+#include <chrono>
 #include <string>
 #include <sstream>
 #include <fstream>
@@ -99,6 +100,7 @@ class Consumer : public clang::ASTConsumer
 
   private:
     FileContext fc_;
+    std::chrono::steady_clock::time_point created_; ///< start of parsing, see --time-report
     clang::ast_matchers::MatchFinder matcher_;
     std::list<std::unique_ptr<Handler>> handlers_;
 };
@@ -25,8 +25,13 @@
 #include <memory>
 #include <vector>
 #include <set>
+#include <string>
+#include <unordered_map>
 #include <functional>
+#include <map>
 #include "vrtlmod/util/utility.hpp"
+#include "vrtlmod/core/journal.hpp"
+#include "vrtlmod/core/typeparser.hpp"
 
 namespace pugi
 {
@@ -90,8 +95,34 @@ class VrtlmodCore
         std::set<std::shared_ptr<types::Target>> injectable_targets_; ///< Vector containing all injectable targets
         std::set<std::shared_ptr<types::Target>>
             toinj_targets_;               ///< Vector containing all from injection targets (filtered signals)
+        std::vector<std::shared_ptr<types::Target>>
+            toinj_vector_; ///< toinj_targets_ in iteration order, base of injection target indices
+        std::unordered_map<std::string, int>
+            toinj_index_; ///< injection target index keyed by "<module id>::<signal id>"
+        bool toinj_index_valid_{ false };
         std::set<fs::path> parsed_files_; ///< parsed files
+        std::set<std::string> input_files_; ///< prepared files, keyed by FileOverlay::get_key()
         std::set<std::unique_ptr<types::Module>> modules_;
+        std::unordered_map<std::string, types::Module *> module_index_;     ///< module id -> module of modules_
+        std::unordered_map<std::string, types::Variable *> variable_index_; ///< "<module id>::<variable id>"
+        std::unordered_map<std::string, types::Cell *> cell_index_;         ///< "<module id>::<cell id>"
+        VlTypeParser type_parser_; ///< memoized parser of variable declarations
+
+        ////////////////////////////////////////////////////////////////////////////////
+        /// @brief Injection location found while analysis is deferred (see VrtlmodCore::defer_analysis())
+        struct DeferredInjectionLocation
+        {
+            std::string module_id_;
+            std::string var_id_;
+            std::string file_;
+            int line_;
+            int column_;
+        };
+        bool analysis_deferred_{ false };
+        std::vector<DeferredInjectionLocation> deferred_inj_locs_; ///< injection locations in order of discovery
+        std::vector<std::pair<std::string, std::string>>
+            deferred_instances_; ///< (module id, instance name) of instances found before their module
+        std::unique_ptr<AnalysisJournal> journal_; ///< records registrations of a shard, see enable_journal()
 
         std::unique_ptr<pugi::xml_document> xml_doc_;
         std::unique_ptr<pugi::xml_node> xml_root_node_;
@@ -154,7 +185,8 @@ class VrtlmodCore
     /// \param files file paths to files ( will sort out *.h/*.hpp and ignore rest)
     void preprocess_headers(const std::vector<std::string> &header_files);
     ///////////////////////////////////////////////////////////////////////
-    /// \brief Postprocess headers according to the API
+    /// \brief Postprocess headers according to the API, adds the model's armed count (vrtlmod_armed_count_) to the
+    ///        symbol table
     /// \param files file paths to files ( will sort out *.h/*.hpp and ignore rest)
     void postprocess_headers(const std::vector<std::string> &header_files);
     ///////////////////////////////////////////////////////////////////////
@@ -175,6 +207,9 @@ class VrtlmodCore
     /// \return number of target instances matching the declaration
     int is_decl_target(const clang::FieldDecl *target) const;
     ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns true if file is one of the prepared input files, see prepare_sources() and prepare_headers()
+    bool is_input_file(const std::string &file) const;
+    ///////////////////////////////////////////////////////////////////////
     /// \brief Returns String containing the (external) declaration of target dictionary (once full decl)
     std::string getTDExternalDecl(void) const;
     ///////////////////////////////////////////////////////////////////////
@@ -187,14 +222,78 @@ class VrtlmodCore
     /// \brief Build VRTLFI XML from analysis and eleboration
     void build_xml(void);
     ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the VRTLFI XML built by build_xml() as string
+    std::string get_xml_string(void) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the part of the analysis result each file's rewrite depends on, keyed by FileOverlay::get_key()
+    /// \details A file's fragment lists the modules declared and the injection targets declared or assigned in it,
+    ///          with all attributes the rewrites use
+    std::map<std::string, std::string> get_analysis_fragments(void) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Save the analyzed files and everything not contained in the XML to the output directory
+    /// \param files Prepared files in the state they were analyzed in
+    void save_analysis_snapshot(const std::vector<std::string> &files) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Load elaboration and analysis from a previous run instead of parsing the VRTL
+    /// \param xml_file VRTL analysis XML of a previous run (see build_xml()) with the same output directory
+    /// \param files Prepared files, restored to the state saved by save_analysis_snapshot()
+    /// \return 0 on success
+    int load_analysis(const std::string &xml_file, const std::vector<std::string> &files);
+    ///////////////////////////////////////////////////////////////////////
     /// \brief Build VRTLFI API
     int build_api(void);
     ///////////////////////////////////////////////////////////////////////
+    /// \brief Defer registering analysis results until resolve_deferred_analysis()
+    /// \details Required when elaboration and analysis run fused in a single traversal: injection locations are then
+    ///          registered after all elaboration results, so the XML is identical to separate passes. The separate
+    ///          elaboration defers as well, for symbol table instances found before their module
+    void defer_analysis(void);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Register all deferred analysis results in order of discovery and stop deferring
+    void resolve_deferred_analysis(void);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Record all following elaboration and analysis results in a journal, see get_journal_unit()
+    void enable_journal(void);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Record all following elaboration and analysis results in a journal, see save_journal()
+    /// \param shard Index of the shard, i.e., the subset of translation units analyzed by this process
+    /// \param shard_count Number of shards
+    /// \param fused Elaboration and analysis run fused (see defer_analysis())
+    void enable_journal(unsigned shard, unsigned shard_count, bool fused);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Name the stage (e.g., "elaborate") of all following results in the journal
+    void set_journal_stage(const std::string &stage);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Write the journal to the output directory
+    int save_journal(void) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the serialized journal of the translation unit with main file `file` in the current stage
+    /// \details The unit only depends on the translation unit, not on the ones analyzed before it
+    std::string get_journal_unit(const std::string &file) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Replay a journal returned by get_journal_unit() as if its translation unit was analyzed now
+    /// \return 0 on success
+    int replay_journal_unit(const std::string &data) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Replay the journals of all shards as if their translation units were analyzed by this process
+    /// \param shard_count Number of shards, their journals are expected in get_shard_dir(output directory, i)
+    /// \param files Prepared files in the order of a single-process run, i.e., the order of the translation units
+    /// \param fused Elaboration and analysis of the shards ran fused
+    /// \return 0 on success
+    /// \details Registrations are replayed stage by stage in the order of files, so the results (and the XML) are
+    ///          identical to a single-process run. Paths into a shard directory are mapped to the output directory
+    int merge_shards(unsigned shard_count, const std::vector<std::string> &files, bool fused);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Output directory of shard `shard` of a run with output directory out_dir
+    static fs::path get_shard_dir(const fs::path &out_dir, unsigned shard);
+    ///////////////////////////////////////////////////////////////////////
     /// \brief Print the TD to std::out
     void print_targetdictionary(void) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief Applies the given xml file as a whitelist to injectable targets upodating to-inject internal target list
-    int initialize_injection_targets(std::string file = "");
+    /// \param patterns If not empty, only targets whose `<module id>::<signal id>` matches any of these glob (or, if
+    ///        prefixed with `re:`, regex) patterns remain
+    int initialize_injection_targets(std::string file = "", const std::vector<std::string> &patterns = {});
 
     std::string get_prefix(types::Cell const *c, std::string module_instance) const;
     std::string get_memberstr(types::Cell const *c, const types::Target &t, const std::string &prefix) const;
@@ -203,6 +302,12 @@ class VrtlmodCore
     std::vector<std::string> prepare_files(const std::vector<std::string> &files,
                                            const std::vector<std::string> &file_ext_matchers, bool overwrite = false);
     ///////////////////////////////////////////////////////////////////////
+    /// \brief Register all variables with an injection location in the XML as injectable targets
+    void collect_injectable_targets(void);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Directory of the analysis snapshot
+    fs::path get_snapshot_dir(void) const;
+    ///////////////////////////////////////////////////////////////////////
     /// \brief Get extracted targets
     std::set<std::shared_ptr<types::Target>> &get_signals(void) const;
     ///////////////////////////////////////////////////////////////////////
@@ -216,6 +321,22 @@ class VrtlmodCore
     /// \param idx Index
     /// \return Reference to Target with index idx
     types::Target &get_target_from_index(int idx) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the index of the injection target with the given parent module and id or -1 if there is none
+    int get_target_index(const std::string &module_id, const std::string &var_id) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Rebuild the injection target index if injection targets were added since the last build
+    void update_target_index(void) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Registry lookups, nullptr if not registered
+    types::Module *find_module(const std::string &module_id) const;
+    types::Variable *find_variable(const std::string &module_id, const std::string &var_id) const;
+    types::Cell *find_cell(const std::string &module_id, const std::string &cell_id) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Take ownership of a module/variable/cell and register it for lookups
+    types::Module *register_module(std::unique_ptr<types::Module> module) const;
+    types::Variable *register_variable(types::Module &module, std::unique_ptr<types::Variable> var) const;
+    types::Cell *register_cell(types::Module &module, std::unique_ptr<types::Cell> cell) const;
     void add_parsed_file(fs::path fpath) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief add a injectable target
@@ -237,27 +358,54 @@ class VrtlmodCore
     void set_top_cell(const pugi::xml_node &node) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief register a cell as the top cell from AST, a top cell has no instance in the symboltable
-    const types::Cell *set_top_cell(const clang::FieldDecl *cell, const clang::ASTContext &ctx) const;
+    /// \param module Module declaring the cell (the symboltable), registered as instance of the top module
+    const types::Cell *set_top_cell(const clang::FieldDecl *cell, const clang::CXXRecordDecl *module,
+                                    const clang::ASTContext &ctx) const;
+    const types::Cell *set_top_cell(const std::string &id, const std::string &cell_type, const std::string &module_id,
+                                    const std::string &instance, const std::string &file, int line, int column) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief register a module (verilated module class) from AST
     const types::Module *add_module(const clang::CXXRecordDecl *module, const clang::ASTContext &ctx) const;
+    const types::Module *add_module(const std::string &id, const std::string &file, int line, int column) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief register a module instance from AST
     const types::Module *add_module_instance(const clang::NamedDecl *instance_decl, const clang::CXXRecordDecl *module,
                                              const clang::ASTContext &ctx) const;
     const types::Module *add_module_instance(const clang::MemberExpr *instance, const clang::CXXRecordDecl *module,
                                              const clang::ASTContext &ctx) const;
+    const types::Module *add_module_instance(const std::string &module_id, const std::string &instance) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief register a module instance or defer it while analysis is deferred and the module is unknown
+    const types::Module *add_or_defer_module_instance(const std::string &module_id, const std::string &instance) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief register a cell (reference to a verilated module class in a verilated module class) from AST
     const types::Cell *add_cell(const clang::FieldDecl *cell, const clang::ASTContext &ctx) const;
+    const types::Cell *add_cell(const std::string &module_id, const std::string &id, const std::string &cell_type,
+                                const std::string &file, int line, int column) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief register a variable (non-internal port or variable in a verilated module class) from AST
     const types::Variable *add_variable(const clang::FieldDecl *variable, const clang::ASTContext &ctx,
                                         const clang::Rewriter &rew) const;
+    /// \param decl Source code of the declaration
+    const types::Variable *add_variable(const std::string &module_id, const std::string &id, const std::string &type,
+                                        const std::string &decl, const std::string &file, int line, int column) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief register a possible injection location with variable
     const types::Variable *add_injection_location(const clang::MemberExpr *assignee, const clang::CXXRecordDecl *parent,
                                                   const clang::ASTContext &ctx) const;
+    const types::Variable *add_injection_location(const std::string &module_id, const std::string &var_id,
+                                                  const std::string &file, int line, int column) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief register a possible injection location or defer it while analysis is deferred
+    const types::Variable *add_or_defer_injection_location(const std::string &module_id, const std::string &var_id,
+                                                           const std::string &file, int line, int column) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Append an event to the journal of the translation unit being processed, if journaling is enabled
+    void record(const clang::ASTContext &ctx, char kind, std::vector<std::string> args) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Register the events of a journal unit, with all paths passed through remap
+    void replay(const AnalysisJournal::Unit &unit,
+                const std::function<std::string(const std::string &path)> &remap) const;
 };
 
 } // namespace vrtlmod
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file fileoverlay.hpp
+/// @brief In-memory overlay of the VRTL sources carried from stage to stage
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRTLMOD_CORE_FILEOVERLAY_HPP__
+#define __VRTLMOD_CORE_FILEOVERLAY_HPP__
+
+#include "vrtlmod/util/utility.hpp"
+
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace llvm
+{
+class raw_ostream;
+namespace vfs
+{
+class FileSystem;
+} // namespace vfs
+} // namespace llvm
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief namespace for all core vrtlmod functionalities
+namespace vrtlmod
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class FileOverlay
+/// @brief Process wide store of the intermediate VRTL sources
+/// @details While disabled, all reads and writes go to disk. Once enabled, writes stay in memory and are only written
+///          to disk by flush(). Clang tools see the overlay through create_vfs(), files that were never written are
+///          read from disk.
+class FileOverlay
+{
+    mutable std::mutex mtx_;
+    bool enabled_{ false };
+    std::map<std::string, std::shared_ptr<const std::string>> files_; ///< absolute path -> current content
+    std::set<std::string> dirty_;                                      ///< files not yet written to disk
+
+    FileOverlay(void) {}
+
+  public:
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the process wide overlay
+    static FileOverlay &get(void);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Normalized absolute path the overlay uses as key of file
+    static std::string get_key(const std::string &file);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Keep all following writes in memory until flush()
+    void enable(void);
+    bool is_enabled(void) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the current content of file
+    std::string read(const fs::path &file) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the current content of file if it is held in memory, nullptr otherwise
+    std::shared_ptr<const std::string> lookup(const std::string &file) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns true if file exists in memory or on disk
+    bool exists(const fs::path &file) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Replace the content of file
+    void write(const fs::path &file, std::string content);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Replace the content of file by the output of producer
+    /// \details Without the overlay, the output is streamed to disk and never held in memory as a whole
+    void write(const fs::path &file, const std::function<void(llvm::raw_ostream &)> &producer);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns a file system that shows the overlay on top of base
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> create_vfs(llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> base);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Write all files changed in memory to disk
+    void flush(void);
+};
+
+} // namespace vrtlmod
+
+#endif // __VRTLMOD_CORE_FILEOVERLAY_HPP__
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file incrementalcache.hpp
+/// @brief Persistent cache of per-file stage results for incremental vrtlmod runs
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRTLMOD_CORE_INCREMENTALCACHE_HPP__
+#define __VRTLMOD_CORE_INCREMENTALCACHE_HPP__
+
+#include "vrtlmod/util/utility.hpp"
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief namespace for all core vrtlmod functionalities
+namespace vrtlmod
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class IncrementalCache
+/// @brief Stores the result of a per-file stage keyed by the file's content before the stage
+/// @details An entry key hashes the salt (vrtlmod version, command line, whitelist), the stage name, a per-file stage
+///          context (e.g., the part of the analysis result the file's rewrite depends on), the file path, its content
+///          and the content of every file the translation unit included. The included files are taken from the
+///          dependency file Clang writes for the translation unit (see get_dependency_file()) and recorded next to the
+///          entry, so the next run can check them before parsing. If a file has the same key as in a previous run,
+///          its stage result is restored and the file skips the stage.
+class IncrementalCache
+{
+  public:
+    using context_t = std::function<std::string(const std::string &file)>;
+
+  private:
+    fs::path dir_;
+    std::string salt_;
+    std::map<std::string, std::vector<std::pair<std::string, std::string>>>
+        pending_; ///< stage -> (file, base key) of files that run the stage
+    std::map<std::string, std::vector<std::pair<std::string, fs::path>>>
+        restored_; ///< stage -> (file, entry) of files restored by store()
+    std::map<std::string, std::map<std::string, std::string>>
+        hashes_;                     ///< stage -> file -> content hash before the stage
+    std::set<std::string> used_{};   ///< entries restored or stored in this run
+    std::set<std::string> stages_{}; ///< stages run in this run
+    size_t hits_{ 0 };
+    size_t misses_{ 0 };
+
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the content hash of file before stage, files not seen before are hashed now
+    const std::string &get_hash(const std::string &stage, const std::string &file);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the entry of file if it is cached. Otherwise file is pending and "" is returned
+    std::string lookup(const std::string &stage, const std::string &file, const context_t &context);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Store data as the result of a pending file
+    void put(const std::string &stage, const std::string &file, const std::string &base, const std::string &data);
+
+  public:
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Look up the results of stage for all files
+    /// \details The cached results are written by store(), so the stage still sees the input of all files
+    /// \param stage Name of the stage
+    /// \param files Files that are about to run the stage
+    /// \param context Additional data the stage result of a file depends on
+    /// \return Files without a cached result, i.e., that still have to run the stage
+    std::vector<std::string> restore(const std::string &stage, const std::vector<std::string> &files,
+                                     const context_t &context = {});
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Restore the cached results of the last restore() of stage and store the current content of all other
+    /// files it returned as their results
+    void store(const std::string &stage);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Look up the result of a stage that produces data instead of changing the file, e.g., an analysis
+    /// \return true and the cached result in data, false if the file has to run the stage and save() its result
+    bool load(const std::string &stage, const std::string &file, std::string &data, const context_t &context = {});
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Save data as the result of a file load() did not find
+    void save(const std::string &stage, const std::string &file, const std::string &data);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Remove all entries of stages run in this run that were neither restored nor stored
+    void prune(void);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Dependency file Clang writes for the translation unit of file (-MD -MF), one per file for all stages
+    fs::path get_dependency_file(const std::string &file) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Number of files that skipped a stage
+    size_t get_hits(void) const { return hits_; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Number of files that ran a stage
+    size_t get_misses(void) const { return misses_; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    /// \param dir Cache directory, created if missing
+    /// \param salt Everything all stage results depend on
+    IncrementalCache(const fs::path &dir, const std::string &salt);
+};
+
+} // namespace vrtlmod
+
+#endif // __VRTLMOD_CORE_INCREMENTALCACHE_HPP__
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file journal.hpp
+/// @brief Record of the elaboration and analysis results of a shard, i.e., a subset of the translation units
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRTLMOD_CORE_JOURNAL_HPP__
+#define __VRTLMOD_CORE_JOURNAL_HPP__
+
+#include <map>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief namespace for all core vrtlmod functionalities
+namespace vrtlmod
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class AnalysisJournal
+/// @brief Registrations with the VrtlmodCore of a shard, grouped by stage and translation unit
+/// @details Replaying the journals of all shards stage by stage in the global order of the translation units repeats
+///          the registrations of a single-process run in the same order, see VrtlmodCore::merge_shards()
+class AnalysisJournal
+{
+  public:
+    enum Kind : char
+    {
+        MODULE = 'M',             ///< module id, file, line, column
+        CELL = 'C',               ///< module id, cell id, cell type, file, line, column
+        VARIABLE = 'V',           ///< module id, variable id, type, declaration, file, line, column
+        TOP_CELL = 'T',           ///< cell id, cell type, module id, instance, file, line, column
+        INSTANCE = 'I',           ///< module id, instance
+        INJECTION_LOCATION = 'L', ///< module id, variable id, file, line, column
+    };
+    struct Event
+    {
+        Kind kind_;
+        std::vector<std::string> args_;
+    };
+    struct Unit
+    {
+        std::string stage_;
+        std::string file_; ///< main file of the translation unit
+        std::vector<Event> events_;
+    };
+
+  private:
+    std::map<std::string, std::string> properties_;
+    std::string stage_;
+    std::vector<Unit> units_;
+
+  public:
+    void set_property(const std::string &key, const std::string &value) { properties_[key] = value; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the property or "" if it is not set
+    std::string get_property(const std::string &key) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Stage of all following records
+    void set_stage(const std::string &stage) { stage_ = stage; }
+    const std::string &get_stage(void) const { return stage_; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Append an event of the translation unit with main file `file`
+    void record(const std::string &file, Kind kind, std::vector<std::string> args);
+    const std::vector<Unit> &get_units(void) const { return units_; }
+    std::vector<Unit> &get_units(void) { return units_; }
+
+    std::string serialize(void) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Replace the content by a serialized journal
+    /// \return false if data is not a complete journal
+    bool parse(const std::string &data);
+};
+
+} // namespace vrtlmod
+
+#endif // __VRTLMOD_CORE_JOURNAL_HPP__
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file toolrunner.hpp
+/// @brief Serial and parallel execution of Clang tool actions on VRTL translation units
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRTLMOD_CORE_TOOLRUNNER_HPP__
+#define __VRTLMOD_CORE_TOOLRUNNER_HPP__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace llvm
+{
+class raw_ostream;
+} // namespace llvm
+
+namespace clang
+{
+namespace tooling
+{
+class ClangTool;
+class CompilationDatabase;
+class ToolAction;
+} // namespace tooling
+class ASTUnit;
+class Rewriter;
+} // namespace clang
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief namespace for all core vrtlmod functionalities
+namespace vrtlmod
+{
+class ASTCache;
+class ASTToolAction;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ToolRunner
+/// @brief Runs a Clang ToolAction over a list of translation units (TUs), serially or on a pool of worker threads
+/// @details In parallel mode every TU is parsed by its own ClangTool instance on one of the workers. Everything that
+///          touches the VrtlmodCore (AST matching, pass actions, rewriter write-back) is sequenced in input order
+///          through ToolRunner::wait_for_turn(), so results are identical to a serial run. Actions that rewrite the
+///          files other TUs read (e.g., the preprocessing passes) run isolated, so no TU depends on the order of the
+///          others.
+///          With an ASTCache, ASTToolActions are run on cached TUs. Only missing or stale TUs are parsed (in parallel
+///          if configured), the action itself then runs on all TUs in input order.
+class ToolRunner
+{
+  public:
+    using adjuster_t = std::function<void(clang::tooling::ClangTool &)>;
+
+  private:
+    const clang::tooling::CompilationDatabase &compilations_;
+    unsigned jobs_;       ///< number of worker threads, 1 runs serially
+    adjuster_t adjuster_; ///< applied to every ClangTool instance before running it
+    ASTCache *cache_{ nullptr };
+
+    int run_serial(const std::vector<std::string> &files, clang::tooling::ToolAction *action) const;
+    int run_parallel(const std::vector<std::string> &files, clang::tooling::ToolAction *action) const;
+    int build_asts(const std::vector<std::string> &files,
+                   std::vector<std::unique_ptr<clang::ASTUnit>> &asts) const;
+
+  public:
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns the number of worker threads
+    unsigned get_jobs(void) const { return jobs_; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Run action on all files
+    /// \param files Source paths of the TUs
+    /// \param action Action executed per TU. Must create a fresh FrontendAction per TU (as all factories do)
+    /// \param isolated If true, no TU sees the rewrites of another TU: files changed via write_changes() or
+    ///                 write_file() are written after all TUs are done
+    /// \return Worst ClangTool::run() result: 0 on success, 1 on failed TUs, 2 on skipped TUs
+    int run(const std::vector<std::string> &files, clang::tooling::ToolAction *action, bool isolated = false) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Run action on all files, reusing parsed TUs of the ASTCache if one is set
+    /// \details Same semantics as the generic run()
+    int run(const std::vector<std::string> &files, ASTToolAction *action, bool isolated = false) const;
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Set the cache of parsed TUs used by ASTToolActions. nullptr disables caching
+    void set_ast_cache(ASTCache *cache) { cache_ = cache; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Blocks the calling thread until all TUs preceding the current one have been fully handled
+    /// \details Call before touching shared state from within a TU's frontend action. No-op outside of parallel runs
+    static void wait_for_turn(void);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Write all files changed by rewriter. Queued until the end of the run() if it is isolated
+    static void write_changes(clang::Rewriter &rewriter);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Replace the content of file by the output of producer. Queued until the end of the run() if it is
+    /// isolated, streamed to a temporary meanwhile unless the FileOverlay is enabled
+    static void write_file(const std::string &file, const std::function<void(llvm::raw_ostream &)> &producer);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    /// \param compilations Compilation database of all TUs
+    /// \param jobs Number of worker threads. 0 selects the number of hardware threads
+    /// \param adjuster Optional ClangTool adjustment, e.g., additional include paths
+    ToolRunner(const clang::tooling::CompilationDatabase &compilations, unsigned jobs, adjuster_t adjuster = {});
+};
+
+} // namespace vrtlmod
+
+#endif // __VRTLMOD_CORE_TOOLRUNNER_HPP__
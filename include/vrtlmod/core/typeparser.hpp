@@ -0,0 +1,75 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file typeparser.hpp
+/// @brief Parser for the C++ type spellings of verilated variable declarations
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRTLMOD_CORE_TYPEPARSER_HPP__
+#define __VRTLMOD_CORE_TYPEPARSER_HPP__
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief namespace for all core vrtlmod functionalities
+namespace vrtlmod
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Signal properties extracted from a variable declaration
+struct VlTypeInfo
+{
+    std::string var_type_{ "undef" }; ///< XML node name: "in", "out" or "var"
+    std::string bases_;               ///< comma separated base types, outermost first
+    std::string dim_;                 ///< comma separated dimensions, innermost as "msb:lsb"
+    long bits_{ 1 };                  ///< total number of bits, <= 0 if extraction failed
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class VlTypeParser
+/// @brief Parses declarations of verilated variables, i.e., port macros (VL_IN*, VL_OUT*, VL_INOUT*), SystemC ports
+///        (sc_in<>, sc_out<>) and signals (CData/SData/IData/QData, VlWide, nested VlUnpacked)
+/// @details Results are memoized. Signal declarations only differ by their name, so the cache key of a signal is its
+///          declaration with the name masked out, and all signals of the same type share one entry.
+class VlTypeParser
+{
+    std::unordered_map<std::string, VlTypeInfo> cache_;
+    size_t hits_{ 0 };
+    size_t misses_{ 0 };
+
+    static VlTypeInfo parse_uncached(std::string_view id, std::string_view type, std::string_view decl);
+
+  public:
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Parse a variable declaration
+    /// \param id Variable name
+    /// \param type Clang type spelling of the variable
+    /// \param decl Source text of the declaration including its verilator comments
+    const VlTypeInfo &parse(const std::string &id, const std::string &type, const std::string &decl);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Number of declarations answered from the cache
+    size_t get_hits(void) const { return hits_; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Number of declarations that had to be parsed
+    size_t get_misses(void) const { return misses_; }
+};
+
+} // namespace vrtlmod
+
+#endif // __VRTLMOD_CORE_TYPEPARSER_HPP__
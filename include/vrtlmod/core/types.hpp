@@ -26,6 +26,8 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 #include <pugixml.hpp>
 
@@ -216,6 +218,14 @@ struct Variable : public Locatable //, public Ancestral<Module>
     }
     virtual ~Variable() {}
 
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Canonical key of all attributes compared by operator==, i.e., equal variables have equal keys
+    std::string get_key(void) const
+    {
+        return util::concat(get_decl_loc(), "\n", get_id(), "\n", get_class(), "\n", std::to_string(get_bits()), "\n",
+                            get_bases(), "\n", get_dimensions(), "\n", get_cxx_type(), "\n", get_type());
+    }
+
     virtual bool operator==(const Variable &rhs) const
     {
         bool ret = (this->get_decl_loc() == rhs.get_decl_loc()) && (this->get_id() == rhs.get_id()) &&
@@ -245,20 +255,41 @@ class Target : public Variable
 
     const Module &parent_;
 
-    std::pair<std::vector<std::string>, std::vector<int>> get_cxx_dimensions(void) const;
-    std::vector<int> get_dimension_lengths(void) const;
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief Typed view of the XML attributes, parsed on first use
+    struct Attributes
+    {
+        int bits_{ 0 };
+        std::vector<int> dimension_lengths_;          ///< lengths of all dimensions, innermost in bits
+        std::vector<std::string> cxx_dimension_types_; ///< data types for unpacked types
+        std::vector<int> cxx_dimension_lengths_;       ///< dimensions of multi-dimensional types
+        std::pair<int, int> element_msb_lsb_{ -1, -1 };
+        unsigned long element_mask_{ 0 };   ///< mask of an element that is not wide
+        unsigned long last_word_mask_{ 0 }; ///< mask of the last word of a wide element
+    };
+    mutable std::unique_ptr<const Attributes> attributes_;
+
+    const Attributes &get_attributes(void) const;
+    std::unique_ptr<const Attributes> parse_attributes(void) const;
+    const std::vector<int> &get_dimension_lengths(void) const { return get_attributes().dimension_lengths_; }
 
   public:
     bool decl_rewritten_{ false };
     ///////////////////////////////////////////////////////////////////////
+    /// \brief Total number of bits
+    int get_bits(void) const override { return get_attributes().bits_; }
+    ///////////////////////////////////////////////////////////////////////
     /// \brief One-dimensional, i.e., element, number of bits
     int get_one_dim_bits(void) const { return get_dimension_lengths().back(); }
     ///////////////////////////////////////////////////////////////////////
     /// \brief Data types for unpacked types
-    std::vector<std::string> get_cxx_dimension_types(void) const;
+    const std::vector<std::string> &get_cxx_dimension_types(void) const
+    {
+        return get_attributes().cxx_dimension_types_;
+    }
     ///////////////////////////////////////////////////////////////////////
     /// \brief Dimensions of multi-dimensional types, e.g., CData[1][5]
-    std::vector<int> get_cxx_dimension_lengths(void) const;
+    const std::vector<int> &get_cxx_dimension_lengths(void) const { return get_attributes().cxx_dimension_lengths_; }
     ///////////////////////////////////////////////////////////////////////
     /// \brief Get parent (module declaring the signal/target)
     const Module &get_parent() const { return parent_; }
@@ -270,7 +301,7 @@ class Target : public Variable
     std::string get_hierarchyDedotted(void) const;
     ///////////////////////////////////////////////////////////////////////
     /// \brief Returns zero dim Most and Least significant bit
-    std::pair<int, int> get_element_msb_lsb_pair(void) const;
+    std::pair<int, int> get_element_msb_lsb_pair(void) const { return get_attributes().element_msb_lsb_; }
     ///////////////////////////////////////////////////////////////////////
     /// \brief Return the elements mask
     unsigned long get_element_mask(std::initializer_list<size_t> subscripts) const;
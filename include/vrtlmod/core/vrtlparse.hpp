@@ -27,6 +27,7 @@
 #include "clang/AST/ASTConsumer.h"
 #include "clang/ASTMatchers/ASTMatchers.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Frontend/ASTUnit.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Rewrite/Frontend/FrontendActions.h"
@@ -38,6 +39,7 @@
 
 #include "vrtlmod/core/consumer.hpp"
 #include "vrtlmod/core/core.hpp"
+#include "vrtlmod/core/toolrunner.hpp"
 
 #include <vector>
 
@@ -56,7 +58,9 @@ class VrtlParser : public Handler
     clang::SourceLocation last_seq_compound_end_;   ///< signals if we are currently in a sequent eval function's scope
     clang::ASTContext *last_seq_compound_ctx_{ nullptr }; ///< store context pointer to invalidate inter-file matching
 
-    std::set<std::unique_ptr<VrtlmodPass>> passes_; ///< passes that extend match based action on parsed source code
+    std::vector<std::unique_ptr<VrtlmodPass>> passes_; ///< passes that extend match based action on parsed source code,
+                                                       ///< executed in order of addition
+    size_t matches_{ 0 }; ///< matches of this parser in this translation unit, see --time-report
   public:
     template <typename llvm_expr_t>
     std::string get_source_code_str(const llvm_expr_t *expr) const;
@@ -264,36 +268,58 @@ std::pair<const clang::MemberExpr *, const clang::CXXRecordDecl *> VrtlParser::p
 ////////////////////////////////////////////////////////////////////////////////
 /// @class ParserAction
 /// @brief Frontend action for LLVM tool executing actions on the AST tree
-template <typename pass_t>
+/// @details All passes share one VrtlParser, i.e., one traversal. They act on each match in the given order
+template <typename... pass_t>
 class ParserAction : public clang::ASTFrontendAction
 {
     clang::Rewriter rewriter_;
     std::string curfile;
     VrtlmodCore &core_;
 
+    static std::unique_ptr<Consumer> create_consumer(VrtlmodCore &core, clang::Rewriter &rewriter,
+                                                     const std::string &file);
+
   public:
     ParserAction(VrtlmodCore &core) : core_{ core } {}
-    void EndSourceFileAction() { rewriter_.overwriteChangedFiles(); }
+    void EndSourceFileAction() { ToolRunner::write_changes(rewriter_); }
 
     // Add own Consumer and code rewriter to it
     std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance &CI, llvm::StringRef InFile);
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Execute the passes on an already parsed translation unit, e.g., from the ASTCache
+    static void run_on_ast(VrtlmodCore &core, clang::ASTUnit &unit);
 };
 
-template <typename pass_t>
-std::unique_ptr<clang::ASTConsumer> ParserAction<pass_t>::CreateASTConsumer(clang::CompilerInstance &CI,
-                                                                            llvm::StringRef InFile)
+template <typename... pass_t>
+std::unique_ptr<Consumer> ParserAction<pass_t...>::create_consumer(VrtlmodCore &core, clang::Rewriter &rewriter,
+                                                                   const std::string &file)
 {
-    curfile = InFile.str();
-    rewriter_.setSourceMgr(CI.getSourceManager(), CI.getLangOpts());
-
-    auto cons = std::make_unique<Consumer>(rewriter_, curfile);
-    auto pass = std::make_unique<pass_t>(core_);
+    auto cons = std::make_unique<Consumer>(rewriter, file);
     auto parser = std::make_unique<VrtlParser>(*cons);
-    parser->add_pass(std::move(pass));
+    (parser->add_pass(std::make_unique<pass_t>(core)), ...);
 
     cons->ownHandler(std::move(parser));
 
-    return std::move(cons);
+    return cons;
+}
+
+template <typename... pass_t>
+std::unique_ptr<clang::ASTConsumer> ParserAction<pass_t...>::CreateASTConsumer(clang::CompilerInstance &CI,
+                                                                               llvm::StringRef InFile)
+{
+    curfile = InFile.str();
+    rewriter_.setSourceMgr(CI.getSourceManager(), CI.getLangOpts());
+
+    return create_consumer(core_, rewriter_, curfile);
+}
+
+template <typename... pass_t>
+void ParserAction<pass_t...>::run_on_ast(VrtlmodCore &core, clang::ASTUnit &unit)
+{
+    clang::Rewriter rewriter(unit.getSourceManager(), unit.getLangOpts());
+    auto cons = create_consumer(core, rewriter, unit.getMainFileName().str());
+    cons->HandleTranslationUnit(unit.getASTContext());
+    ToolRunner::write_changes(rewriter);
 }
 
 } // namespace vrtlmod
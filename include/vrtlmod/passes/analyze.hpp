@@ -42,6 +42,7 @@ class AnalyzePass final : public VrtlmodPass
     ///////////////////////////////////////////////////////////////////////
     /// \brief VrtlmodPass action during AST traversal in VrtlParse
     void action(const VrtlParser &parser, const clang::ast_matchers::MatchFinder::MatchResult &Result) const;
+    const char *get_name(void) const override { return "AnalyzePass"; }
     ///////////////////////////////////////////////////////////////////////
     /// \brief Constructor
     /// \param core Reference to vrtlmod core storing signal and injection data
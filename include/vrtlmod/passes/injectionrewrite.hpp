@@ -99,15 +99,50 @@ class InjectionRewriter final : public VrtlmodPass
     {
         VrtlParser const &parser_;
         std::vector<std::shared_ptr<SInj>> asngs_{};
+        std::vector<std::shared_ptr<CompoundStmt>> children_{}; ///< directly nested compounds, ordered by location
         void add_assignment(std::shared_ptr<SInj> a) { asngs_.push_back(a); }
         std::vector<std::shared_ptr<SInj>> get_dominant_assignments(void) const;
         const clang::Stmt *c_;
+        unsigned begin(void) const { return c_->getBeginLoc().getRawEncoding(); }
+        unsigned end(void) const { return c_->getEndLoc().getRawEncoding(); }
 
         CompoundStmt(const clang::Stmt *c, VrtlParser const &parser) : parser_(parser), c_(c) {}
         virtual ~CompoundStmt(void) {}
     };
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief Nesting tree of the compound statements of one sequential function. Compounds either nest or do not
+    /// overlap, so each level is ordered by location and searched binary.
+    struct CompoundTree
+    {
+        std::vector<std::shared_ptr<CompoundStmt>> roots_{};
+        ///////////////////////////////////////////////////////////////////////
+        /// \brief Insert a compound below its finest enclosing compound. Returns the already inserted one for the
+        /// same statement
+        std::shared_ptr<CompoundStmt> insert(std::shared_ptr<CompoundStmt> compound);
+        ///////////////////////////////////////////////////////////////////////
+        /// \brief Returns the innermost compound enclosing the given source range, nullptr if none
+        std::shared_ptr<CompoundStmt> find_finest(unsigned begin, unsigned end) const;
+        ///////////////////////////////////////////////////////////////////////
+        /// \brief Call `f` for all compounds, nested compounds before the compounds enclosing them
+        template <typename F>
+        void foreach_bottom_up(F f) const
+        {
+            foreach_bottom_up(roots_, f);
+        }
+
+      private:
+        template <typename F>
+        static void foreach_bottom_up(const std::vector<std::shared_ptr<CompoundStmt>> &level, F &f)
+        {
+            for (auto const &it : level)
+            {
+                foreach_bottom_up(it->children_, f);
+                f(*it);
+            }
+        }
+    };
 
-    mutable std::map<const clang::FunctionDecl *, std::vector<std::shared_ptr<CompoundStmt>>> map_seq_compounds_;
+    mutable std::map<const clang::FunctionDecl *, CompoundTree> map_seq_compounds_;
     mutable const clang::FunctionDecl *active_sequent_func_{ nullptr };
     mutable CompoundStmt *active_compound_{ nullptr }; ///< active compound statement
     std::shared_ptr<CompoundStmt> get_finest_compound(const clang::FunctionDecl *f, const clang::Expr *expr) const;
@@ -134,6 +169,7 @@ class InjectionRewriter final : public VrtlmodPass
     ///////////////////////////////////////////////////////////////////////
     /// \brief VrtlmodPass action during AST traversal in VrtlParse
     void action(const VrtlParser &parser, const clang::ast_matchers::MatchFinder::MatchResult &Result) const;
+    const char *get_name(void) const override { return "InjectionRewriter"; }
     ///////////////////////////////////////////////////////////////////////
     /// \brief Constructor
     /// \param core Reference to vrtlmod core storing signal and injection data
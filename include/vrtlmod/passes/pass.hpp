@@ -43,6 +43,9 @@ class VrtlmodPass
     /// \brief execute some code at end of translation
     virtual void end_of_translation(const VrtlParser &parser) const {(void) parser;}
     ///////////////////////////////////////////////////////////////////////
+    /// \brief Name of the pass, e.g., in the time report
+    virtual const char *get_name(void) const = 0;
+    ///////////////////////////////////////////////////////////////////////
     /// \brief Get reference to VrtlmodCore
     const VrtlmodCore &get_core() const { return vrtlmod_core_; }
     ///////////////////////////////////////////////////////////////////////
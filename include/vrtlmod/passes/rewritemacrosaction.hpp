@@ -60,10 +60,16 @@ namespace transform
 /// @brief namespace for LLVM/Clang source to source transformation rewriter tooling
 namespace rewrite
 {
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Replaces all macro uses of the main file by their expansion
+/// @details Uses clang::RewriteMacrosInInput, or a streaming equivalent that neither materializes the token stream nor
+///          the rewritten file
 class RewriteMacrosAction : public clang::PreprocessorFrontendAction
 {
+    bool streaming_;
+
   public:
-    RewriteMacrosAction();
+    RewriteMacrosAction(bool streaming = false);
     void ExecuteAction();
 };
 
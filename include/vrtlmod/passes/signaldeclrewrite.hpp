@@ -50,6 +50,7 @@ class SignalDeclRewriter : public VrtlmodPass
     ///////////////////////////////////////////////////////////////////////
     /// \brief VrtlmodPass action during AST traversal in VrtlParse
     void action(const VrtlParser &parser, const clang::ast_matchers::MatchFinder::MatchResult &Result) const;
+    const char *get_name(void) const override { return "SignalDeclRewriter"; }
     ///////////////////////////////////////////////////////////////////////
     /// \brief Prints analysis of rewrite work done
     void analyzeRewrite(void);
@@ -63,6 +64,7 @@ class SignalDeclRewriter : public VrtlmodPass
 
   private:
     std::set<clang::SourceLocation> visited;
+    mutable bool includes_modified_{ false }; ///< target dictionary include added to this TU's main file
 };
 
 } // namespace passes
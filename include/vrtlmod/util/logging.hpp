@@ -49,6 +49,9 @@ enum LEVEL
 };
 
 const char *toString(LEVEL level);
+
+extern bool silent_;  ///< see toggle_silent()
+extern bool verbose_; ///< see toggle_verbose()
 ////////////////////////////////////////////////////////////////////////////////
 /// \brief Toggle silent output (false on reset)
 void toggle_silent(void);
@@ -56,6 +59,20 @@ void toggle_silent(void);
 /// \brief Toggle verbose output (false on reset)
 void toggle_verbose(void);
 ////////////////////////////////////////////////////////////////////////////////
+/// \brief Returns true if messages of level are written. Silent output only keeps errors and obligatory messages
+inline bool is_enabled(LEVEL level)
+{
+    if (level == ERROR || level == OBLIGAT)
+    {
+        return true;
+    }
+    return !silent_ && (level != VERBOSE || verbose_);
+}
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Write the log to file instead of std::cout. Lines are buffered, errors are also written to std::cout
+/// \return false if the file could not be opened, the log then stays on std::cout
+bool set_log_file(const std::string &file);
+////////////////////////////////////////////////////////////////////////////////
 /// \brief Log helper function
 void log(LEVEL level, const std::string &msg, bool silent_toggle = false, bool verbose_toggle = false);
 
@@ -115,31 +132,24 @@ void LOG(Strings &&...strings)
 
 } // namespace util
 
-template <typename... Strings>
-void LOG_VERBOSE(Strings &&...strings)
-{
-    util::logging::LOG<util::logging::VERBOSE>(std::forward<Strings>(strings)...);
-}
-template <typename... Strings>
-void LOG_INFO(Strings &&...strings)
-{
-    util::logging::LOG<util::logging::INFO>(std::forward<Strings>(strings)...);
-}
-template <typename... Strings>
-void LOG_ERROR(Strings &&...strings)
-{
-    util::logging::LOG<util::logging::ERROR>(std::forward<Strings>(strings)...);
-}
-template <typename... Strings>
-void LOG_OBLIGAT(Strings &&...strings)
-{
-    util::logging::LOG<util::logging::OBLIGAT>(std::forward<Strings>(strings)...);
-}
-template <typename... Strings>
-void LOG_WARNING(Strings &&...strings)
-{
-    util::logging::LOG<util::logging::WARNING>(std::forward<Strings>(strings)...);
-}
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Log the concatenation of all arguments. Arguments are only evaluated if the level is enabled, so expensive
+///        ones, e.g., dump_to_str(), cost nothing while the level is off
+#define VRTLMOD_LOG_LAZY(LEVEL, ...)                  \
+    do                                                \
+    {                                                 \
+        if (::util::logging::is_enabled(LEVEL))       \
+        {                                             \
+            ::util::logging::LOG<LEVEL>(__VA_ARGS__); \
+        }                                             \
+    } while (0)
+
+#define LOG_VERBOSE(...) VRTLMOD_LOG_LAZY(::util::logging::VERBOSE, __VA_ARGS__)
+#define LOG_INFO(...) VRTLMOD_LOG_LAZY(::util::logging::INFO, __VA_ARGS__)
+#define LOG_ERROR(...) VRTLMOD_LOG_LAZY(::util::logging::ERROR, __VA_ARGS__)
+#define LOG_OBLIGAT(...) VRTLMOD_LOG_LAZY(::util::logging::OBLIGAT, __VA_ARGS__)
+#define LOG_WARNING(...) VRTLMOD_LOG_LAZY(::util::logging::WARNING, __VA_ARGS__)
+
 template <typename... Strings>
 void LOG_FATAL(Strings &&...strings)
 {
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file timereport.hpp
+/// @brief Per-stage wall time, CPU time and peak memory of a vrtlmod run (`--time-report`)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRTLMOD_UTIL_TIMEREPORT_HPP__
+#define __VRTLMOD_UTIL_TIMEREPORT_HPP__
+
+#include <chrono>
+#include <string>
+
+namespace util
+{
+
+namespace timereport
+{
+
+extern bool enabled_; ///< see enable()
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Start recording. All other functions are no-ops until then
+void enable(void);
+inline bool is_enabled(void)
+{
+    return enabled_;
+}
+////////////////////////////////////////////////////////////////////////////////
+/// \brief End the current stage (if any) and start measuring the next one
+void begin_stage(const std::string &name);
+////////////////////////////////////////////////////////////////////////////////
+/// \brief End the current stage
+void end_stage(void);
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Add parse and match time of file to the current stage. Thread-safe
+void add_file_time(const std::string &file, double parse_seconds, double match_seconds);
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Add matches of a parser, named by its passes, to the current stage. Thread-safe
+void add_matches(const std::string &passes, size_t count);
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Human readable report of all stages
+std::string to_text(void);
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Report of all stages as JSON object
+std::string to_json(void);
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Seconds since start
+inline double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace timereport
+
+} // namespace util
+
+#endif // __VRTLMOD_UTIL_TIMEREPORT_HPP__
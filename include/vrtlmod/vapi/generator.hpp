@@ -36,6 +36,12 @@ namespace vrtlmod
 
 class VrtlmodCore;
 
+namespace types
+{
+class Target;
+class Cell;
+} // namespace types
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief namespace for all API building functionalities
 namespace vapi
@@ -162,12 +168,30 @@ class VapiGenerator
         std::string generate_header(std::string filename) const override;
     } vapi_td_python_module_{ *this };
 
+  public:
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief Symbol table instance of an injection target as written by the API templates
+    struct TargetInstance
+    {
+        const types::Cell *cell_;     ///< cell instantiating the target's module
+        std::string prefix_;          ///< instance prefix, see VrtlmodCore::get_prefix()
+        std::string memberstr_;       ///< VRTL member access, see VrtlmodCore::get_memberstr()
+        const types::Target *target_; ///< injection target
+    };
+
+  private:
     std::vector<std::string> prepare_files(const std::vector<std::string> &files,
                                            const std::vector<std::string> &file_ext_matchers, bool overwrite);
     const VrtlmodCore &core_;
+    mutable std::vector<TargetInstance> target_instances_{};
+    mutable bool target_instances_valid_{ false };
 
   public:
     const VrtlmodCore &get_core() const { return core_; }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Returns all injection target instances grouped by module (sorted by id), target (sorted by id) and
+    ///        symbol table instance. Built on first use, the order defines the target ids of all generated files
+    const std::vector<TargetInstance> &get_target_instances(void) const;
 
   public:
     std::string get_targetdictionary_filename(void) const { return (API_TD_HEADER_NAME); }
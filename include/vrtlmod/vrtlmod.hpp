@@ -37,16 +37,24 @@ class FrontendActionFactory;
 namespace vrtlmod
 {
 class VrtlmodCore;
+class ASTToolAction;
 ///////////////////////////////////////////////////////////////////////
 /// \brief Returns vrtlmod version as string
 const std::string &get_version(void);
 
-std::unique_ptr<clang::tooling::ToolAction> CreateMacroRewritePass(VrtlmodCore &core);
+///////////////////////////////////////////////////////////////////////
+/// \brief Macro expansion of the VRTL sources
+/// \param streaming Use the streaming rewriter instead of clang::RewriteMacrosInInput
+std::unique_ptr<clang::tooling::ToolAction> CreateMacroRewritePass(VrtlmodCore &core, bool streaming = false);
 std::unique_ptr<clang::tooling::ToolAction> CreateCommentRewritePass(VrtlmodCore &core);
-std::unique_ptr<clang::tooling::ToolAction> CreateElaboratePass(VrtlmodCore &core);
-std::unique_ptr<clang::tooling::ToolAction> CreateAnalyzePass(VrtlmodCore &core);
-std::unique_ptr<clang::tooling::ToolAction> CreateSignalDeclPass(VrtlmodCore &core);
-std::unique_ptr<clang::tooling::ToolAction> CreateInjectionPass(VrtlmodCore &core);
+std::unique_ptr<ASTToolAction> CreateElaboratePass(VrtlmodCore &core);
+std::unique_ptr<ASTToolAction> CreateAnalyzePass(VrtlmodCore &core);
+///////////////////////////////////////////////////////////////////////
+/// \brief Elaboration and analysis in a single traversal. Call VrtlmodCore::defer_analysis() before running it and
+///        VrtlmodCore::resolve_deferred_analysis() after
+std::unique_ptr<ASTToolAction> CreateElaborateAnalyzePass(VrtlmodCore &core);
+std::unique_ptr<ASTToolAction> CreateSignalDeclPass(VrtlmodCore &core);
+std::unique_ptr<ASTToolAction> CreateInjectionPass(VrtlmodCore &core);
 
 } // namespace vrtlmod
 
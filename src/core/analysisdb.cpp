@@ -0,0 +1,284 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file analysisdb.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/analysisdb.hpp"
+
+#include <pugixml.hpp>
+
+#include <charconv>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vrtlmod
+{
+namespace analysisdb
+{
+
+namespace
+{
+bool parse_int(std::string_view str, long &value)
+{
+    auto res = std::from_chars(str.data(), str.data() + str.size(), value);
+    return res.ec == std::errc() && res.ptr == str.data() + str.size();
+}
+
+std::string_view trim(std::string_view str)
+{
+    auto first = str.find_first_not_of(' ');
+    if (first == std::string_view::npos)
+    {
+        return {};
+    }
+    return str.substr(first, str.find_last_not_of(' ') - first + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Removes the enclosing brackets of a list, e.g., `[a, b]`
+std::string_view unbracket(std::string_view str)
+{
+    str = trim(str);
+    if (str.size() >= 2 && str.front() == '[' && str.back() == ']')
+    {
+        str = str.substr(1, str.size() - 2);
+    }
+    return str;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Calls func for each trimmed element of a comma separated (and bracketed) list, e.g., `[a, b]`
+template <typename Func> void foreach_element(std::string_view list, Func func)
+{
+    list = unbracket(list);
+    while (!list.empty())
+    {
+        auto comma = list.find(',');
+        func(trim(list.substr(0, comma)));
+        list = (comma == std::string_view::npos) ? std::string_view() : list.substr(comma + 1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Collects the records of all sections
+struct Builder
+{
+    std::string strings_{ '\0' }; ///< starts with the empty string
+    std::unordered_map<std::string, uint32_t> string_refs_{ { "", 0 } };
+    std::unordered_map<long, uint32_t> file_index_;         ///< file id -> FILES index
+    std::unordered_map<std::string, uint32_t> module_index_; ///< module id -> MODULES index
+
+    std::vector<FileRecord> files_;
+    std::vector<ModuleRecord> modules_;
+    std::vector<CellRecord> cells_;
+    std::vector<VariableRecord> variables_;
+    std::vector<DimensionRecord> dimensions_;
+    std::vector<Location> locations_;
+
+    uint32_t add_string(const std::string &str)
+    {
+        auto it = string_refs_.find(str);
+        if (it != string_refs_.end())
+        {
+            return it->second;
+        }
+        uint32_t ref = strings_.size();
+        strings_.append(str).push_back('\0');
+        string_refs_.emplace(str, ref);
+        return ref;
+    }
+
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Parse a locator `f<id>:l<line>:c<column>`
+    Location parse_location(std::string_view loc) const
+    {
+        Location ret{ NONE, 0, 0 };
+        long file = 0, line = 0, column = 0;
+        auto l = loc.find(":l");
+        auto c = loc.find(":c");
+        if (loc.size() < 2 || l == std::string_view::npos || c == std::string_view::npos ||
+            !parse_int(loc.substr(1, l - 1), file) || !parse_int(loc.substr(l + 2, c - (l + 2)), line) ||
+            !parse_int(loc.substr(c + 2), column))
+        {
+            return ret;
+        }
+        auto it = file_index_.find(file);
+        ret.file_ = (it != file_index_.end()) ? it->second : NONE;
+        ret.line_ = line;
+        ret.column_ = column;
+        return ret;
+    }
+
+    void add_file(const pugi::xml_node &node)
+    {
+        long id = 0;
+        std::string_view id_str = node.attribute("id").value();
+        if (id_str.empty() || !parse_int(id_str.substr(1), id))
+        {
+            return;
+        }
+        file_index_.emplace(id, files_.size());
+        files_.push_back(FileRecord{ uint32_t(id), add_string(node.attribute("path").value()) });
+    }
+
+    void add_cell(const pugi::xml_node &node, uint32_t parent)
+    {
+        std::string type = node.attribute("type").value();
+        auto it = module_index_.find(type);
+        cells_.push_back(CellRecord{ add_string(node.attribute("id").value()), add_string(type),
+                                     (it != module_index_.end()) ? it->second : NONE, parent,
+                                     parse_location(node.attribute("decl_loc").value()) });
+    }
+
+    void add_variable(const pugi::xml_node &node, uint32_t module)
+    {
+        std::string_view name = node.name();
+        VariableRecord rec{};
+        rec.id_ = add_string(node.attribute("id").value());
+        rec.module_ = module;
+        rec.kind_ = (name == "in") ? IN : (name == "out") ? OUT : (name == "inout") ? INOUT : VAR;
+        rec.bits_ = node.attribute("bits").as_int();
+        rec.cxx_type_ = add_string(node.attribute("cxx_type").value());
+        rec.bases_ = add_string(std::string(unbracket(node.attribute("bases").value())));
+
+        rec.first_dimension_ = dimensions_.size();
+        foreach_element(node.attribute("dim").value(), [&](std::string_view dim) {
+            long msb = 0, lsb = 0;
+            auto colon = dim.find(':');
+            if (colon != std::string_view::npos)
+            {
+                if (!parse_int(dim.substr(0, colon), msb) || !parse_int(dim.substr(colon + 1), lsb))
+                {
+                    msb = lsb = -1;
+                }
+            }
+            else if (parse_int(dim, msb))
+            {
+                msb -= 1; // unpacked length
+            }
+            else
+            {
+                msb = lsb = -1;
+            }
+            dimensions_.push_back(DimensionRecord{ int32_t(msb), int32_t(lsb) });
+        });
+        rec.dimension_count_ = dimensions_.size() - rec.first_dimension_;
+
+        rec.decl_ = parse_location(node.attribute("decl_loc").value());
+        rec.first_inj_loc_ = locations_.size();
+        foreach_element(node.attribute("inj_loc").value(),
+                        [&](std::string_view loc) { locations_.push_back(parse_location(loc)); });
+        rec.inj_loc_count_ = locations_.size() - rec.first_inj_loc_;
+        variables_.push_back(rec);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Converts the 32 bit words of [begin, end) from host order to little-endian
+void to_little_endian(std::string &data, size_t begin, size_t end)
+{
+    if (host_is_little_endian())
+    {
+        return;
+    }
+    for (size_t i = begin; i + 4 <= end; i += 4)
+    {
+        std::swap(data[i], data[i + 3]);
+        std::swap(data[i + 1], data[i + 2]);
+    }
+}
+
+template <typename T> void append_section(std::string &out, Header &header, Section s, const T *data, size_t count)
+{
+    static_assert(sizeof(T) == 1 || sizeof(T) % 4 == 0, "records must consist of 32 bit fields");
+    out.resize((out.size() + 7) & ~size_t(7), '\0');
+    header.sections_[s] = SectionEntry{ uint32_t(out.size()), uint32_t(count) };
+    out.append(reinterpret_cast<const char *>(data), count * sizeof(T));
+    if (sizeof(T) != 1)
+    {
+        to_little_endian(out, header.sections_[s].offset_, out.size());
+    }
+}
+} // namespace
+
+std::string serialize(const pugi::xml_node &root)
+{
+    Builder b;
+    for (auto const &node : root.child("files").children("file"))
+    {
+        b.add_file(node);
+    }
+    // cells may instantiate modules declared later in the XML
+    for (auto const &node : root.child("modules").children("module"))
+    {
+        b.module_index_.emplace(node.attribute("id").value(), b.module_index_.size());
+    }
+
+    for (auto const &node : root.child("top").children("cell"))
+    {
+        b.add_cell(node, NONE);
+    }
+    uint32_t top_cell = b.cells_.empty() ? NONE : 0;
+
+    for (auto const &node : root.child("modules").children("module"))
+    {
+        uint32_t module = b.modules_.size();
+        ModuleRecord rec{};
+        rec.id_ = b.add_string(node.attribute("id").value());
+        rec.decl_ = b.parse_location(node.attribute("decl_loc").value());
+        rec.first_cell_ = b.cells_.size();
+        rec.first_variable_ = b.variables_.size();
+        for (auto const &child : node.children())
+        {
+            std::string_view name = child.name();
+            if (name == "cell")
+            {
+                b.add_cell(child, module);
+            }
+            else if (name == "in" || name == "out" || name == "inout" || name == "var")
+            {
+                b.add_variable(child, module);
+            }
+        }
+        rec.cell_count_ = b.cells_.size() - rec.first_cell_;
+        rec.variable_count_ = b.variables_.size() - rec.first_variable_;
+        b.modules_.push_back(rec);
+    }
+
+    Header header{};
+    std::memcpy(header.magic_, MAGIC, sizeof(MAGIC));
+    header.version_ = VERSION;
+    header.top_cell_ = top_cell;
+
+    std::string ret(sizeof(Header), '\0');
+    append_section(ret, header, STRINGS, b.strings_.data(), b.strings_.size());
+    append_section(ret, header, FILES, b.files_.data(), b.files_.size());
+    append_section(ret, header, MODULES, b.modules_.data(), b.modules_.size());
+    append_section(ret, header, CELLS, b.cells_.data(), b.cells_.size());
+    append_section(ret, header, VARIABLES, b.variables_.data(), b.variables_.size());
+    append_section(ret, header, DIMENSIONS, b.dimensions_.data(), b.dimensions_.size());
+    append_section(ret, header, LOCATIONS, b.locations_.data(), b.locations_.size());
+    std::memcpy(&ret[0], &header, sizeof(Header));
+    to_little_endian(ret, sizeof(MAGIC), sizeof(Header));
+    return ret;
+}
+
+} // namespace analysisdb
+} // namespace vrtlmod
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file astcache.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/astcache.hpp"
+#include "vrtlmod/core/fileoverlay.hpp"
+#include "vrtlmod/util/logging.hpp"
+#include "vrtlmod/util/utility.hpp"
+
+#include "clang/Basic/SourceManager.h"
+
+namespace vrtlmod
+{
+
+ASTCache::ASTCache(void) {}
+ASTCache::~ASTCache(void) {}
+
+uint64_t ASTCache::get_hash(const std::string &file)
+{
+    auto it = hashes_.find(file);
+    if (it != hashes_.end())
+    {
+        return it->second;
+    }
+
+    uint64_t hash = UINT64_MAX; // missing files never match
+    if (FileOverlay::get().exists(file))
+    {
+        hash = util::hash(FileOverlay::get().read(file));
+    }
+    hashes_[file] = hash;
+    return hash;
+}
+
+clang::ASTUnit *ASTCache::get(const std::string &file)
+{
+    auto it = entries_.find(file);
+    if (it == entries_.end())
+    {
+        ++misses_;
+        return nullptr;
+    }
+    for (auto const &dep : it->second.deps_)
+    {
+        if (get_hash(dep.first) != dep.second)
+        {
+            LOG_VERBOSE("AST of [", file, "] is stale, [", dep.first, "] changed");
+            entries_.erase(it);
+            ++misses_;
+            return nullptr;
+        }
+    }
+    ++hits_;
+    return it->second.unit_.get();
+}
+
+void ASTCache::store(const std::string &file, std::unique_ptr<clang::ASTUnit> unit)
+{
+    Entry entry;
+    const clang::SourceManager &sm = unit->getSourceManager();
+    for (auto it = sm.fileinfo_begin(); it != sm.fileinfo_end(); ++it)
+    {
+#if LLVM_VERSION_MAJOR < 18
+        std::string dep = it->first->getName().str();
+#else
+        std::string dep = it->first.getName().str();
+#endif
+        entry.deps_[dep] = get_hash(dep);
+    }
+    entry.unit_ = std::move(unit);
+    entries_[file] = std::move(entry);
+}
+
+} // namespace vrtlmod
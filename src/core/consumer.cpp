@@ -20,6 +20,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "vrtlmod/core/consumer.hpp"
+#include "vrtlmod/core/toolrunner.hpp"
+#include "vrtlmod/util/timereport.hpp"
 
 using namespace clang;
 using namespace clang::ast_matchers;
@@ -63,7 +65,10 @@ bool Handler::inThisFile(clang::SourceLocation sl)
     return getRewriter().getSourceMgr().getFileID(sl) == getRewriter().getSourceMgr().getMainFileID();
 }
 
-Consumer::Consumer(clang::Rewriter &rw, const std::string &file) : fc_(rw, file) {}
+Consumer::Consumer(clang::Rewriter &rw, const std::string &file)
+    : fc_(rw, file), created_(std::chrono::steady_clock::now())
+{
+}
 
 void Consumer::ownHandler(std::unique_ptr<Handler> handler)
 {
@@ -75,9 +80,15 @@ void Consumer::Initialize(ASTContext &Context) {}
 
 void Consumer::HandleTranslationUnit(ASTContext &Context)
 {
+    // the consumer is created right before parsing, so this excludes waiting for the turn
+    double parse_time = util::timereport::seconds_since(created_);
+    // parsing may run concurrently, matching and pass actions on the shared core are sequenced in input order
+    ToolRunner::wait_for_turn();
+    auto match_start = std::chrono::steady_clock::now();
     fc_.context_ = &Context;
     matcher_.matchAST(Context);
     fc_.context_ = 0;
+    util::timereport::add_file_time(fc_.file_, parse_time, util::timereport::seconds_since(match_start));
 }
 
 } // namespace vrtlmod
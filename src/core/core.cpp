@@ -20,6 +20,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "vrtlmod/core/core.hpp"
+#include "vrtlmod/core/analysisdb.hpp"
+#include "vrtlmod/core/fileoverlay.hpp"
+#include "vrtlmod/core/journal.hpp"
 #include "vrtlmod/core/types.hpp"
 #include "vrtlmod/passes/pass.hpp"
 #include "vrtlmod/util/logging.hpp"
@@ -39,16 +42,31 @@
 #include "clang/Rewrite/Core/Rewriter.h"
 #include "clang/Lex/Lexer.h"
 #include "clang/AST/TextNodeDumper.h"
+#include "llvm/Support/GlobPattern.h"
+#include "llvm/Support/Regex.h"
 
 #include <pugixml.hpp>
-#include <regex>
 #include <algorithm>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <unordered_set>
 
-#include <boost/lexical_cast.hpp>
 
 namespace vrtlmod
 {
 
+namespace
+{
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Registry key of a module member (variable, cell or target)
+std::string get_member_key(const std::string &module_id, const std::string &member_id)
+{
+    return util::concat(module_id, "::", member_id);
+}
+} // namespace
+
 VrtlmodCore::VrtlmodCore(const char *out_dir_path, bool systemc)
     : out_dir_path_(out_dir_path)
     , systemc_(systemc)
@@ -130,6 +148,10 @@ std::vector<std::string> VrtlmodCore::prepare_files(const std::vector<std::strin
             nfile = dst.string();
         }
     }
+    for (auto const &it : nfiles)
+    {
+        ctx_->input_files_.insert(FileOverlay::get_key(it));
+    }
     return nfiles;
 }
 
@@ -137,7 +159,7 @@ void clean_file(const std::string &file_path)
 {
     LOG_VERBOSE("> cleaning file", file_path);
 
-    std::string data = util::file2string(file_path);
+    std::string data = FileOverlay::get().read(file_path);
     size_t pos = 0;
     do
     {
@@ -147,14 +169,14 @@ void clean_file(const std::string &file_path)
 
     } while (pos != std::string::npos);
 
-    util::string2file(file_path, data);
+    FileOverlay::get().write(file_path, data);
 }
 
 void remove_anonstructs(const std::string &file_path)
 {
     LOG_VERBOSE("> removing anonymous structs from file[", file_path, "]");
 
-    std::string data = util::file2string(file_path);
+    std::string data = FileOverlay::get().read(file_path);
     size_t pos = 0;
 
     do
@@ -170,7 +192,7 @@ void remove_anonstructs(const std::string &file_path)
 
     } while (pos != std::string::npos);
 
-    util::string2file(file_path, data);
+    FileOverlay::get().write(file_path, data);
 }
 
 std::vector<std::string> VrtlmodCore::prepare_sources(const std::vector<std::string> &files, bool overwrite)
@@ -194,7 +216,7 @@ void reintroduce_anonstructs(const std::string &file_path)
 {
     LOG_VERBOSE("> Adding anonymous structs to", file_path);
 
-    std::string data = util::file2string(file_path);
+    std::string data = FileOverlay::get().read(file_path);
     size_t pos = 0;
     do
     {
@@ -209,7 +231,7 @@ void reintroduce_anonstructs(const std::string &file_path)
 
     } while (pos != std::string::npos);
 
-    util::string2file(file_path, data);
+    FileOverlay::get().write(file_path, data);
 }
 
 void VrtlmodCore::preprocess_headers(const std::vector<std::string> &header_files)
@@ -220,11 +242,51 @@ void VrtlmodCore::preprocess_headers(const std::vector<std::string> &header_file
     }
 }
 
+void add_armed_count(const std::string &file_path, const std::string &syms_class)
+{
+    std::string data = FileOverlay::get().read(file_path);
+    if (data.find("vrtlmod_armed_count_") != std::string::npos)
+    {
+        return;
+    }
+    // the class definition, not a forward declaration
+    size_t pos = 0;
+    while ((pos = data.find("class " + syms_class, pos)) != std::string::npos)
+    {
+        pos += 6 + syms_class.size();
+        if (data.find('{', pos) < data.find(';', pos))
+        {
+            break;
+        }
+    }
+    size_t pub = (pos != std::string::npos) ? data.find("public:", pos) : std::string::npos;
+    if (pub == std::string::npos)
+    {
+        LOG_FATAL("No public section of symbol table class [", syms_class, "] in ", file_path);
+    }
+    LOG_VERBOSE("> Adding armed count to ", syms_class, " in ", file_path);
+    data.insert(pub + 7, "\n    // vrtlmod: armed target dictionary entries of this model, see VRTLMOD_INJECT"
+                         "\n    unsigned vrtlmod_armed_count_ = 0;");
+
+    FileOverlay::get().write(file_path, data);
+}
+
 void VrtlmodCore::postprocess_headers(const std::vector<std::string> &header_files)
 {
+    const std::string syms_header = get_vrtltopsymsheader_filename();
+    bool syms_found = false;
     for (const auto &it : header_files)
     {
         reintroduce_anonstructs(it);
+        if (fs::path(it).filename() == syms_header)
+        {
+            add_armed_count(it, fs::path(syms_header).stem().string());
+            syms_found = true;
+        }
+    }
+    if (!syms_found)
+    {
+        LOG_WARNING("Symbol table header ", syms_header, " is not an input, the VRTL will not compile with the API");
     }
 }
 
@@ -268,62 +330,83 @@ std::string VrtlmodCore::getTDExternalDecl(void) const
 
 int VrtlmodCore::is_decl_target(const clang::FieldDecl *target) const
 {
-    int ret = -1;
-    std::string t_type = target->getType().getAsString();
     std::string t_name = target->getName().str();
-    std::string t_a_type = target->getParent()->getTypeForDecl()->getTypeClassName();
     std::string t_a_name = target->getParent()->getName().str();
 
-    LOG_VERBOSE("t_a_name: ", t_a_name, " of type ", t_a_type);
-    LOG_VERBOSE("t_name: ", t_name, " of type ", t_type);
+    LOG_VERBOSE("t_a_name: ", t_a_name, " t_name: ", t_name);
 
-    bool found = false;
-    auto func = [&](const types::Target &it) {
-        ++ret;
-        std::string target_name = it.get_id();
-        std::string target_parent = types::Module(it.parent()).get_id();
+    return get_target_index(t_a_name, t_name);
+}
 
-        LOG_VERBOSE(">> target:", target_name, " of parent ", target_parent, " of type ", it.parent().name());
-        if (t_a_name == target_parent)
-        {
-            LOG_VERBOSE(">>> same ancestor:", t_a_name, " of type ", t_a_type);
+types::Target &VrtlmodCore::get_target_from_index(int idx) const
+{
+    update_target_index();
+    return *(ctx_->toinj_vector_.at(idx));
+}
 
-            if (t_name == target_name)
-            {
-                found = true;
-                LOG_VERBOSE(">>> same target:", t_name, " of type ", t_type);
-                return false;
-            }
-        }
-        return true;
-    };
-    foreach_injection_target(func);
+int VrtlmodCore::get_target_index(const std::string &module_id, const std::string &var_id) const
+{
+    update_target_index();
+    auto it = ctx_->toinj_index_.find(get_member_key(module_id, var_id));
+    return (it != ctx_->toinj_index_.end()) ? it->second : -1;
+}
 
-    return found ? ret : -1;
+void VrtlmodCore::update_target_index(void) const
+{
+    if (ctx_->toinj_index_valid_)
+    {
+        return;
+    }
+    ctx_->toinj_vector_.assign(ctx_->toinj_targets_.begin(), ctx_->toinj_targets_.end());
+    ctx_->toinj_index_.clear();
+    ctx_->toinj_index_.reserve(ctx_->toinj_vector_.size());
+    for (size_t i = 0; i < ctx_->toinj_vector_.size(); ++i)
+    {
+        const types::Target &t = *ctx_->toinj_vector_[i];
+        // first target wins, as with the former linear search
+        ctx_->toinj_index_.emplace(get_member_key(types::Module(t.parent()).get_id(), t.get_id()), i);
+    }
+    ctx_->toinj_index_valid_ = true;
 }
 
-types::Target &VrtlmodCore::get_target_from_index(int idx) const
+void VrtlmodCore::record(const clang::ASTContext &ctx, char kind, std::vector<std::string> args) const
 {
-    return (**std::next(ctx_->toinj_targets_.begin(), idx));
+    if (!ctx_->journal_)
+    {
+        return;
+    }
+    const auto &sm = ctx.getSourceManager();
+#if LLVM_VERSION_MAJOR < 17
+    std::string file = sm.getFileEntryForID(sm.getMainFileID())->getName().str();
+#else
+    std::string file = sm.getFileEntryRefForID(sm.getMainFileID())->getName().str();
+#endif
+    ctx_->journal_->record(file, AnalysisJournal::Kind(kind), std::move(args));
 }
 
 const types::Module *VrtlmodCore::add_module(const clang::CXXRecordDecl *module, const clang::ASTContext &ctx) const
 {
     std::string id = module->getNameAsString();
-    std::set<std::unique_ptr<types::Module>>::iterator mod_iter;
-    mod_iter =
-        std::find_if(ctx_->modules_.begin(), ctx_->modules_.end(), [id](const auto &it) { return id == it->get_id(); });
-    if (mod_iter == ctx_->modules_.end())
+    const auto &sm = ctx.getSourceManager();
+    std::string file = LOCATABLE_GET_FILENAME_FROM_CLANG(module->getLocation(), sm).str();
+    int line = LOCATABLE_GET_LINE_FROM_CLANG(module->getLocation(), sm);
+    int column = LOCATABLE_GET_COL_FROM_CLANG(module->getLocation(), sm);
+    record(ctx, AnalysisJournal::MODULE, { id, file, std::to_string(line), std::to_string(column) });
+    return add_module(id, file, line, column);
+}
+
+const types::Module *VrtlmodCore::add_module(const std::string &id, const std::string &file, int line,
+                                             int column) const
+{
+    if (find_module(id) == nullptr)
     {
         auto xml_node = ctx_->xml_modules_node_->append_child("module");
         xml_node.append_attribute("id") = id.c_str();
         auto mod_inst = std::make_unique<types::Module>(xml_node);
 
-        mod_inst->add_decl_loc(LOCATABLE_INITIALIZER(module->getLocation(), ctx.getSourceManager()));
-        const types::Module *ret = mod_inst.get();
+        mod_inst->add_decl_loc(file, line, column);
 
-        ctx_->modules_.insert(std::move(mod_inst));
-        return ret;
+        return register_module(std::move(mod_inst));
     }
     else
     {
@@ -337,16 +420,35 @@ const types::Module *VrtlmodCore::add_module_instance(const clang::NamedDecl *in
                                                       const clang::ASTContext &ctx) const
 {
     std::string id = module->getNameAsString();
-    std::set<std::unique_ptr<types::Module>>::iterator mod_iter;
-    mod_iter =
-        std::find_if(ctx_->modules_.begin(), ctx_->modules_.end(), [id](const auto &it) { return id == it->get_id(); });
+    std::string instance = instance_decl->getNameAsString();
+    record(ctx, AnalysisJournal::INSTANCE, { id, instance });
+    return add_or_defer_module_instance(id, instance);
+}
+
+const types::Module *VrtlmodCore::add_or_defer_module_instance(const std::string &module_id,
+                                                               const std::string &instance) const
+{
+    const types::Module *ret = add_module_instance(module_id, instance);
+    if (ret == nullptr && ctx_->analysis_deferred_)
+    {
+        LOG_VERBOSE("{instance}: [", instance, "] of module [", module_id, "] deferred, module not yet elaborated");
+        ctx_->deferred_instances_.push_back(std::make_pair(module_id, instance));
+    }
+    else if (ret == nullptr)
+    {
+        LOG_WARNING("{instance}: [", instance, "] no matching module [", module_id, "] found.");
+    }
+    return ret;
+}
 
-    if (mod_iter != ctx_->modules_.end())
+const types::Module *VrtlmodCore::add_module_instance(const std::string &module_id, const std::string &instance) const
+{
+    types::Module *module = find_module(module_id);
+    if (module != nullptr)
     {
-        (*mod_iter)->add_instance(instance_decl->getNameAsString());
-        return (*mod_iter).get();
+        module->add_instance(instance);
     }
-    return nullptr;
+    return module;
 }
 
 const types::Module *VrtlmodCore::add_module_instance(const clang::MemberExpr *instance,
@@ -366,36 +468,41 @@ const types::Cell *VrtlmodCore::add_cell(const clang::FieldDecl *cell, const cla
     util::strhelp::replaceAll(cell_type, " ", "");
     std::string module_id = cell->getParent()->getName().str();
 
-    std::set<std::unique_ptr<types::Module>>::iterator mod_iter;
-    mod_iter = std::find_if(ctx_->modules_.begin(), ctx_->modules_.end(),
-                            [module_id](const auto &it) { return module_id == it->get_id(); });
-    if (mod_iter == ctx_->modules_.end())
+    const auto &sm = ctx.getSourceManager();
+    std::string file = LOCATABLE_GET_FILENAME_FROM_CLANG(cell->getLocation(), sm).str();
+    int line = LOCATABLE_GET_LINE_FROM_CLANG(cell->getLocation(), sm);
+    int column = LOCATABLE_GET_COL_FROM_CLANG(cell->getLocation(), sm);
+    record(ctx, AnalysisJournal::CELL,
+           { module_id, id, cell_type, file, std::to_string(line), std::to_string(column) });
+    return add_cell(module_id, id, cell_type, file, line, column);
+}
+
+const types::Cell *VrtlmodCore::add_cell(const std::string &module_id, const std::string &id,
+                                         const std::string &cell_type, const std::string &file, int line,
+                                         int column) const
+{
+    types::Module *module = find_module(module_id);
+    if (module == nullptr)
     {
         LOG_VERBOSE("{cell}: [", id, "] of type [", cell_type, "] no matchting parent [", module_id, "] found");
         return nullptr;
     }
 
-    std::set<std::unique_ptr<types::Cell>>::iterator cell_iter;
-    cell_iter = std::find_if((*mod_iter)->cells_.begin(), (*mod_iter)->cells_.end(),
-                             [id](const auto &it) { return id == it->get_id(); });
-    if (cell_iter != (*mod_iter)->cells_.end())
+    if (find_cell(module_id, id) != nullptr)
     {
         LOG_VERBOSE("{cell}: [", id, "] of type [", cell_type, "]  already a member of parent [", module_id, "]");
         return nullptr;
     }
 
-    auto xml_node = (*mod_iter)->append_child("cell");
+    auto xml_node = module->append_child("cell");
     xml_node.append_attribute("id") = id.c_str();
     xml_node.append_attribute("type") = cell_type.c_str();
 
     auto cell_instance = std::make_unique<types::Cell>(xml_node); //, **mod_iter);
 
-    cell_instance->add_decl_loc(LOCATABLE_INITIALIZER(cell->getLocation(), ctx.getSourceManager()));
-    const types::Cell *ret = cell_instance.get();
+    cell_instance->add_decl_loc(file, line, column);
 
-    (*mod_iter)->add_cell(std::move(cell_instance));
-
-    return ret;
+    return register_cell(*module, std::move(cell_instance));
 }
 
 const types::Variable *VrtlmodCore::add_variable(const clang::FieldDecl *variable, const clang::ASTContext &ctx,
@@ -408,19 +515,15 @@ const types::Variable *VrtlmodCore::add_variable(const clang::FieldDecl *variabl
     std::string type = variable->getType().getAsString();
     std::string module_id = variable->getParent()->getName().str();
 
-    std::set<std::unique_ptr<types::Module>>::iterator mod_iter;
-    mod_iter = std::find_if(ctx_->modules_.begin(), ctx_->modules_.end(),
-                            [module_id](const auto &it) { return module_id == it->get_id(); });
-    if (mod_iter == ctx_->modules_.end())
+    // a shard has to record variables of modules elaborated by other shards, and the journal unit of a translation
+    // unit must not depend on the translation units before it (see get_journal_unit())
+    if (find_module(module_id) == nullptr && !ctx_->journal_)
     {
         LOG_VERBOSE("{variable}: [", id, "] of parent [", module_id, "] no matching parent module found.");
         return nullptr;
     }
 
-    std::set<std::unique_ptr<types::Variable>>::iterator var_iter;
-    var_iter = std::find_if((*mod_iter)->variables_.begin(), (*mod_iter)->variables_.end(),
-                            [id](const auto &it) { return id == it->get_id(); });
-    if (var_iter != (*mod_iter)->variables_.end())
+    if (find_variable(module_id, id) != nullptr && !ctx_->journal_)
     {
         LOG_VERBOSE("{variable}: [", id, "] of type [", type, "]  already a member of parent [", module_id, "]");
         return nullptr;
@@ -438,192 +541,34 @@ const types::Variable *VrtlmodCore::add_variable(const clang::FieldDecl *variabl
     LOG_VERBOSE("{decl_source_range}:", decl_complete_range.printToString(srcmgr));
     LOG_VERBOSE("{decl_source_code_text}:", decl_source_code_text);
 
-    std::regex ctype_portdecl("/\\*VL_IN[1-9]*\\*/|/\\*VL_OUT[1-9]*\\*/|/\\*VL_INOUT[1-9]*\\*/");
-    std::regex wctype_portdecl("/\\*VL_INW*\\*/|/\\*VL_OUTW*\\*/|/\\*VL_INOUTW*\\*/");
-    std::regex sctype_portdecl("sc_in<|sc_out<");
-
-    std::string var_type = "undef";
-    std::string msb = "msb";
-    std::string lsb = "lsb";
-    std::vector<std::pair<std::string, std::string>> unpacked;
-
-    auto unpack = [&unpacked](std::string &packed_str, const std::regex &break_regex) {
-        auto open_templ = packed_str.find("<");
-        auto close_templ = packed_str.rfind(">");
-        auto comma = packed_str.rfind(",");
-        std::string outer_type = packed_str.substr(0, open_templ);
-        std::string outer_dim = packed_str.substr(comma + 1, close_templ - (comma + 1));
-        auto base = packed_str.substr(0, open_templ);
-        packed_str = packed_str.substr(open_templ + 1, comma - (open_templ + 1));
-        unpacked.push_back(std::make_pair<>(std::string(base), std::string(outer_dim)));
-        bool cont = std::regex_search(packed_str, break_regex);
-        if (!cont)
-        {
-            unpacked.push_back(std::make_pair<>(std::string(packed_str), std::string(outer_dim)));
-        }
-        return cont;
-    };
+    std::string file = LOCATABLE_GET_FILENAME_FROM_CLANG(variable->getLocation(), srcmgr).str();
+    int line = LOCATABLE_GET_LINE_FROM_CLANG(variable->getLocation(), srcmgr);
+    int column = LOCATABLE_GET_COL_FROM_CLANG(variable->getLocation(), srcmgr);
+    record(ctx, AnalysisJournal::VARIABLE,
+           { module_id, id, type, decl_source_code_text, file, std::to_string(line), std::to_string(column) });
+    return add_variable(module_id, id, type, decl_source_code_text, file, line, column);
+}
 
-    if (std::regex_search(decl_source_code_text, ctype_portdecl))
-    {
-        auto first_col = decl_source_code_text.rfind(id) + id.length() + 1;
-        auto second_col = decl_source_code_text.find(",", first_col + 1);
-        msb = decl_source_code_text.substr(first_col, second_col - first_col);
-        auto last_brace = decl_source_code_text.rfind(")*/;");
-        ++second_col;
-
-        lsb = decl_source_code_text.substr(second_col, last_brace - second_col);
-        var_type = std::regex_search(decl_source_code_text, std::regex("/\\*VL_IN[1-9]*\\*/")) ? "in" : "out";
-        auto cxx_base_type_str = decl_source_code_text.substr(0, decl_source_code_text.find(id) - 1);
-        unpacked.push_back(std::make_pair<>(std::string(cxx_base_type_str), std::string("0")));
-        LOG_VERBOSE(">>>: is a ctype ", var_type, " from ", msb, " to ", lsb);
-    }
-    else if (std::regex_search(decl_source_code_text, wctype_portdecl))
-    {
-        auto first_col = decl_source_code_text.rfind(id) + id.length() + 1;
-        auto second_col = decl_source_code_text.find(",", first_col + 1);
-        auto third_col = decl_source_code_text.find(",", second_col + 1);
-        msb = decl_source_code_text.substr(first_col, second_col - first_col);
-        auto last_brace = decl_source_code_text.rfind(")*/;");
-        ++second_col;
-        lsb = decl_source_code_text.substr(second_col, third_col - second_col);
-        var_type = std::regex_search(decl_source_code_text, std::regex("/\\*VL_INW*\\*/")) ? "in" : "out";
-        auto cxx_base_type_str = decl_source_code_text.substr(0, decl_source_code_text.find(id) - 1);
-#if VRTLMOD_VERILATOR_VERSION <= 4204
-        auto openbrace = decl_source_code_text.find('[');
-        auto closebrace = decl_source_code_text.find(']');
-        cxx_base_type_str += decl_source_code_text.substr(openbrace, closebrace - openbrace + 1);
-#else // VRTLMOD_VERILATOR_VERSION <= 4228
-#endif
-        unpacked.push_back(std::make_pair<>(std::string(cxx_base_type_str), std::string("0")));
-        LOG_VERBOSE(">>>: is a wctype ", var_type, " from ", msb, " to ", lsb);
-    }
-    else if (std::regex_search(decl_source_code_text, sctype_portdecl))
+const types::Variable *VrtlmodCore::add_variable(const std::string &module_id, const std::string &id,
+                                                 const std::string &type, const std::string &decl,
+                                                 const std::string &file, int line, int column) const
+{
+    types::Module *module = find_module(module_id);
+    if (module == nullptr)
     {
-        var_type = std::regex_search(decl_source_code_text, std::regex("sc_in<")) ? "in" : "out";
-        auto cxx_base_type_str = decl_source_code_text.substr(0, decl_source_code_text.find(id));
-
-        bool still_going = false;
-        std::string search = decl_source_code_text; // var_type;
-
-        auto open_templ = search.find("<");
-        auto close_templ = search.rfind(">");
-        auto outer_str = search.substr(0, open_templ);
-        auto inner_str = search.substr(open_templ + 1, close_templ - (open_templ + 1));
-
-        if (std::regex_search(inner_str, std::regex("^sc_bv<")))
-        {
-            auto open_templ = inner_str.find("<");
-            auto close_templ = inner_str.rfind(">");
-            msb = std::to_string(std::stoi(inner_str.substr(open_templ + 1, close_templ - (open_templ + 1))) - 1);
-            lsb = "0";
-        }
-        else if (std::regex_search(inner_str, std::regex("int64_")))
-        {
-            msb = "63";
-            lsb = "0";
-        }
-        else if (std::regex_search(inner_str, std::regex("int32_")))
-        {
-            msb = "31";
-            lsb = "0";
-        }
-        else if (std::regex_search(inner_str, std::regex("int16_")))
-        {
-            msb = "15";
-            lsb = "0";
-        }
-        else if (std::regex_search(inner_str, std::regex("int8_")))
-        {
-            msb = "7";
-            lsb = "0";
-        }
-        else if (std::regex_search(inner_str, std::regex("^bool|^Bool_|^Bool")))
-        {
-            msb = "0";
-            lsb = "0";
-        }
-        else
-        {
-            msb = "undef";
-            lsb = "undef";
-        }
-
-        unpacked.push_back(std::make_pair<>(std::string(cxx_base_type_str), std::string("0")));
-        LOG_VERBOSE(">>>: is a sctype port ", outer_str, " - ", inner_str, "!!!");
-
-        // TODO: Support bitfield extraction for systemc type ports (only top level is systemc, but only
-        // sc_{in,out}<stdint> is supported)
+        LOG_VERBOSE("{variable}: [", id, "] of parent [", module_id, "] no matching parent module found.");
+        return nullptr;
     }
-    else // something else aka must be a signal
-    {
-        if (std::regex_search(type, std::regex("^VlUnpacked<")))
-        {
-            bool still_going = false;
-            std::string search = decl_source_code_text; // type;
-            do
-            {
-                still_going = unpack(search, std::regex("^VlUnpacked<"));
-            } while (still_going);
-        }
-        else // packed signal
-        {
-            std::string type_str;
-            auto close_space = decl_source_code_text.find(" ");
-            type_str = decl_source_code_text.substr(0, close_space);
-
-            unpacked.push_back(std::make_pair<>(std::string(type_str), std::string("0")));
-        }
-
-        std::string zerodim_typestr = unpacked.back().first;
-        auto open_comm = zerodim_typestr.find("/*");
-        auto colon_comm = zerodim_typestr.find(":");
-        auto close_comm = zerodim_typestr.rfind("*/");
-        msb = zerodim_typestr.substr(open_comm + 2, colon_comm - (open_comm + 2));
-        lsb = zerodim_typestr.substr(colon_comm + 1, close_comm - (colon_comm + 1));
-        var_type = "var";
-    }
-
-    unpacked.back().second = util::concat(msb, ":", lsb);
-    unpacked.back().first = unpacked.back().first.substr(0, unpacked.back().first.find("/*"));
-    std::string bases, dim;
-    long bits = 1;
-    bool first_base = true;
-    for (auto &pair_ : unpacked)
-    {
-        // now we can clean whitespaces
-        pair_.first.erase(
-            std::remove_if(pair_.first.begin(), pair_.first.end(), [](unsigned char x) { return std::isspace(x); }),
-            pair_.first.end());
-        pair_.second.erase(
-            std::remove_if(pair_.second.begin(), pair_.second.end(), [](unsigned char x) { return std::isspace(x); }),
-            pair_.second.end());
-
-        if (first_base)
-        {
-            first_base = false;
-            bases = pair_.first;
-            dim = pair_.second;
-        }
-        else
-        {
-            bases = util::concat(bases, ", ", pair_.first);
-            dim = util::concat(dim, ", ", pair_.second);
-        }
 
-        int new_dim_bits = 0;
-        try
-        {
-            bits *= (pair_.second.find(":") == std::string::npos)
-                        ? boost::lexical_cast<int>(pair_.second)
-                        : ((boost::lexical_cast<int>(msb) + 1) - boost::lexical_cast<int>(lsb));
-        }
-        catch (boost::bad_lexical_cast)
-        {
-            bits *= 0; // force total bit length to zero to trigger invalidation.
-        }
+    if (find_variable(module_id, id) != nullptr)
+    {
+        LOG_VERBOSE("{variable}: [", id, "] of type [", type, "]  already a member of parent [", module_id, "]");
+        return nullptr;
     }
 
+    const VlTypeInfo &type_info = ctx_->type_parser_.parse(id, type, decl);
+    long bits = type_info.bits_;
+
     if (bits <= 0)
     {
         // FIXME: normally we should not have any string types here, since AST matchers should be configured to filter
@@ -642,24 +587,23 @@ const types::Variable *VrtlmodCore::add_variable(const clang::FieldDecl *variabl
         return nullptr;
     }
 
-    auto xml_node = (*mod_iter)->append_child(var_type.c_str());
+    auto xml_node = module->append_child(type_info.var_type_.c_str());
     xml_node.append_attribute("id") = id.c_str();
-    xml_node.append_attribute("bases") = util::concat("[", bases, "]").c_str();
-    xml_node.append_attribute("dim") = util::concat("[", dim, "]").c_str();
+    xml_node.append_attribute("bases") = util::concat("[", type_info.bases_, "]").c_str();
+    xml_node.append_attribute("dim") = util::concat("[", type_info.dim_, "]").c_str();
     xml_node.append_attribute("cxx_type") = type.c_str();
     // xml_node.append_attribute("decl") = decl_source_code_text.c_str();
     xml_node.append_attribute("bits") = bits;
 
     auto var_inst = std::make_unique<types::Variable>(xml_node); //, **it);
 
-    var_inst->add_decl_loc(LOCATABLE_INITIALIZER(variable->getLocation(), ctx.getSourceManager()));
-    const types::Variable *ret = var_inst.get();
+    var_inst->add_decl_loc(file, line, column);
 
-    (*mod_iter)->add_variable(std::move(var_inst));
-    return ret;
+    return register_variable(*module, std::move(var_inst));
 }
 
-const types::Cell *VrtlmodCore::set_top_cell(const clang::FieldDecl *cell, const clang::ASTContext &ctx) const
+const types::Cell *VrtlmodCore::set_top_cell(const clang::FieldDecl *cell, const clang::CXXRecordDecl *module,
+                                             const clang::ASTContext &ctx) const
 {
     std::string id = cell->getNameAsString();
     std::string cell_type = cell->getType().getAsString();
@@ -668,8 +612,20 @@ const types::Cell *VrtlmodCore::set_top_cell(const clang::FieldDecl *cell, const
     util::strhelp::replaceAll(cell_type, "*", "");
     util::strhelp::replaceAll(cell_type, " ", "");
 
-    std::string parent_id = cell->getParent()->getName().str();
+    std::string module_id = module->getNameAsString();
+    const auto &sm = ctx.getSourceManager();
+    std::string file = LOCATABLE_GET_FILENAME_FROM_CLANG(cell->getLocation(), sm).str();
+    int line = LOCATABLE_GET_LINE_FROM_CLANG(cell->getLocation(), sm);
+    int column = LOCATABLE_GET_COL_FROM_CLANG(cell->getLocation(), sm);
+    record(ctx, AnalysisJournal::TOP_CELL,
+           { id, cell_type, module_id, id, file, std::to_string(line), std::to_string(column) });
+    return set_top_cell(id, cell_type, module_id, id, file, line, column);
+}
 
+const types::Cell *VrtlmodCore::set_top_cell(const std::string &id, const std::string &cell_type,
+                                             const std::string &module_id, const std::string &instance,
+                                             const std::string &file, int line, int column) const
+{
     if (ctx_->top_cell_.get())
     {
         LOG_VERBOSE("Top cell already set to [", ctx_->top_cell_->get_id(), "] of type [", ctx_->top_cell_->get_type(),
@@ -685,8 +641,9 @@ const types::Cell *VrtlmodCore::set_top_cell(const clang::FieldDecl *cell, const
 
         ctx_->top_cell_ = std::make_unique<types::Cell>(xml_node);
 
-        ctx_->top_cell_->add_decl_loc(LOCATABLE_INITIALIZER(cell->getLocation(), ctx.getSourceManager()));
+        ctx_->top_cell_->add_decl_loc(file, line, column);
 
+        add_or_defer_module_instance(module_id, instance);
         return ctx_->top_cell_.get();
     }
 }
@@ -694,28 +651,20 @@ const types::Cell *VrtlmodCore::set_top_cell(const clang::FieldDecl *cell, const
 int VrtlmodCore::is_expr_target(const clang::MemberExpr *assignee, const clang::CXXRecordDecl *parent,
                                 const clang::ASTContext &ctx) const
 {
-    int ret = -1;
-    bool found = false;
-
     std::string var_id = assignee->getMemberNameInfo().getAsString(); // assignee->getNameAsString();
     std::string var_type = assignee->getType().getAsString();
     std::string module_id = parent->getName().str();
     std::string module_type = parent->getTypeForDecl()->getTypeClassName();
 
     LOG_VERBOSE(">>>>> INJREW: {variable}: [", var_id, "] of parent [", module_id, "]");
-    std::set<std::unique_ptr<types::Module>>::iterator mod_iter;
-    mod_iter = std::find_if(ctx_->modules_.begin(), ctx_->modules_.end(),
-                            [module_id](const auto &it) { return module_id == it->get_id(); });
-    if (mod_iter == ctx_->modules_.end())
+    if (find_module(module_id) == nullptr)
     {
         LOG_WARNING(">>>>> INJREW: {variable}: [", var_id, "] of parent [", module_id, "] no matching module found.");
         return -1;
     }
 
-    std::set<std::unique_ptr<types::Variable>>::iterator var_iter;
-    var_iter = std::find_if((*mod_iter)->variables_.begin(), (*mod_iter)->variables_.end(),
-                            [var_id](const auto &it) { return var_id == it->get_id(); });
-    if (var_iter == (*mod_iter)->variables_.end())
+    const types::Variable *var = find_variable(module_id, var_id);
+    if (var == nullptr)
     {
         LOG_WARNING(">>>>> INJREW: {variable}: [", var_id, "] of parent [", module_id,
                     "] no matching variable found in module.");
@@ -723,24 +672,19 @@ int VrtlmodCore::is_expr_target(const clang::MemberExpr *assignee, const clang::
     }
     else
     {
-        LOG_VERBOSE(">>>>> INJREW: {variable}: [", (*var_iter)->get_id(), "] of parent [", module_id,
-                    "] found injection location at ", "<TODO>", " of set [", (*var_iter)->get_inj_loc(), "]");
-
-        auto func = [&](const types::Target &it) {
-            ++ret;
-            if (it.is_assigned_here(assignee, parent))
-            {
-                found = true;
-                LOG_VERBOSE(">>>>> INJREW: target is assigned here", it.get_id(), " of type ", it.get_type(),
-                            " of parent ", types::Module(it.parent()).get_id());
-                return false;
-            }
-            return true;
-        };
-        foreach_injection_target(func);
+        LOG_VERBOSE(">>>>> INJREW: {variable}: [", var->get_id(), "] of parent [", module_id,
+                    "] found injection location at ", "<TODO>", " of set [", var->get_inj_loc(), "]");
+
+        // Target::is_assigned_here() compares the member name and the record declaring the member
+        std::string decl_ancestor_name =
+            static_cast<const clang::FieldDecl *>(assignee->getMemberDecl())->getParent()->getName().str();
+        int ret = get_target_index(decl_ancestor_name, var_id);
+        if (ret >= 0)
+        {
+            LOG_VERBOSE(">>>>> INJREW: target is assigned here", var_id, " of parent ", decl_ancestor_name);
+        }
+        return ret;
     }
-
-    return found ? ret : -1;
 }
 
 const types::Variable *VrtlmodCore::add_injection_location(const clang::MemberExpr *assignee,
@@ -748,42 +692,303 @@ const types::Variable *VrtlmodCore::add_injection_location(const clang::MemberEx
                                                            const clang::ASTContext &ctx) const
 {
     std::string var_id = assignee->getMemberNameInfo().getAsString(); // assignee->getNameAsString();
-    std::string var_type = assignee->getType().getAsString();
     std::string module_id = parent->getName().str();
-    std::string module_type = parent->getTypeForDecl()->getTypeClassName();
+    const auto &sm = ctx.getSourceManager();
+    std::string file = LOCATABLE_GET_FILENAME_FROM_CLANG(assignee->getExprLoc(), sm).str();
+    int line = LOCATABLE_GET_LINE_FROM_CLANG(assignee->getExprLoc(), sm);
+    int column = LOCATABLE_GET_COL_FROM_CLANG(assignee->getExprLoc(), sm);
+    record(ctx, AnalysisJournal::INJECTION_LOCATION,
+           { module_id, var_id, file, std::to_string(line), std::to_string(column) });
+    return add_or_defer_injection_location(module_id, var_id, file, line, column);
+}
+
+const types::Variable *VrtlmodCore::add_or_defer_injection_location(const std::string &module_id,
+                                                                    const std::string &var_id,
+                                                                    const std::string &file, int line,
+                                                                    int column) const
+{
+    if (ctx_->analysis_deferred_)
+    {
+        LOG_VERBOSE("{variable}: [", var_id, "] of parent [", module_id, "] injection location deferred");
+        ctx_->deferred_inj_locs_.push_back({ module_id, var_id, file, line, column });
+        return nullptr;
+    }
+    return add_injection_location(module_id, var_id, file, line, column);
+}
 
+const types::Variable *VrtlmodCore::add_injection_location(const std::string &module_id, const std::string &var_id,
+                                                           const std::string &file, int line, int column) const
+{
     LOG_VERBOSE("{variable}: [", var_id, "] of parent [", module_id, "]");
-    std::set<std::unique_ptr<types::Module>>::iterator mod_iter;
-    mod_iter = std::find_if(ctx_->modules_.begin(), ctx_->modules_.end(),
-                            [module_id](const auto &it) { return module_id == it->get_id(); });
-    if (mod_iter == ctx_->modules_.end())
+    if (find_module(module_id) == nullptr)
     {
         LOG_VERBOSE("{variable}: [", var_id, "] of parent [", module_id, "] no matching module found.");
         return nullptr;
     }
 
-    std::set<std::unique_ptr<types::Variable>>::iterator var_iter;
-    var_iter = std::find_if((*mod_iter)->variables_.begin(), (*mod_iter)->variables_.end(),
-                            [var_id](const auto &it) { return var_id == it->get_id(); });
-    if (var_iter == (*mod_iter)->variables_.end())
+    types::Variable *var = find_variable(module_id, var_id);
+    if (var == nullptr)
     {
         LOG_VERBOSE("{variable}: [", var_id, "] of parent [", module_id, "] no matching variable found in module.");
         return nullptr;
     }
     else
     {
-        if ((*var_iter)->get_type() == "in")
+        if (var->get_type() == "in")
         {
-            LOG_VERBOSE("{variable}: [", (*var_iter)->get_id(), "] of parent [", module_id,
-                        "] found injection location at[", (*var_iter)->get_inj_loc(), "] - skip variable is input!");
+            LOG_VERBOSE("{variable}: [", var->get_id(), "] of parent [", module_id, "] found injection location at[",
+                        var->get_inj_loc(), "] - skip variable is input!");
             return nullptr;
         }
-        LOG_VERBOSE("{variable}: [", (*var_iter)->get_id(), "] of parent [", module_id,
-                    "] found injection location at[", (*var_iter)->get_inj_loc(), "]");
-        (*var_iter)->add_inj_loc(LOCATABLE_INITIALIZER(assignee->getExprLoc(), ctx.getSourceManager()));
+        LOG_VERBOSE("{variable}: [", var->get_id(), "] of parent [", module_id, "] found injection location at[",
+                    var->get_inj_loc(), "]");
+        var->add_inj_loc(file, line, column);
+
+        return var;
+    }
+}
+
+void VrtlmodCore::defer_analysis(void)
+{
+    ctx_->analysis_deferred_ = true;
+}
+
+void VrtlmodCore::resolve_deferred_analysis(void)
+{
+    ctx_->analysis_deferred_ = false;
+
+    for (auto const &it : ctx_->deferred_instances_)
+    {
+        if (add_module_instance(it.first, it.second) == nullptr)
+        {
+            LOG_WARNING("{instance}: [", it.second, "] no matching module [", it.first, "] found.");
+        }
+    }
+    for (auto const &it : ctx_->deferred_inj_locs_)
+    {
+        add_injection_location(it.module_id_, it.var_id_, it.file_, it.line_, it.column_);
+    }
+    LOG_INFO("Resolved ", std::to_string(ctx_->deferred_inj_locs_.size()), " deferred injection locations");
+    ctx_->deferred_instances_.clear();
+    ctx_->deferred_inj_locs_.clear();
+}
+
+fs::path VrtlmodCore::get_shard_dir(const fs::path &out_dir, unsigned shard)
+{
+    return out_dir / ".vrtlmod-shards" / std::to_string(shard);
+}
+
+void VrtlmodCore::enable_journal(void)
+{
+    if (!ctx_->journal_)
+    {
+        ctx_->journal_ = std::make_unique<AnalysisJournal>();
+        ctx_->journal_->set_property("base_dir", FileOverlay::get_key(out_dir_path_.string()));
+        ctx_->journal_->set_property("version", VRTLMOD_VERSION);
+    }
+}
+
+void VrtlmodCore::enable_journal(unsigned shard, unsigned shard_count, bool fused)
+{
+    enable_journal();
+    ctx_->journal_->set_property("shard", std::to_string(shard));
+    ctx_->journal_->set_property("shard_count", std::to_string(shard_count));
+    ctx_->journal_->set_property("fused", fused ? "1" : "0");
+}
+
+void VrtlmodCore::set_journal_stage(const std::string &stage)
+{
+    if (ctx_->journal_)
+    {
+        ctx_->journal_->set_stage(stage);
+    }
+}
+
+int VrtlmodCore::save_journal(void) const
+{
+    if (!ctx_->journal_)
+    {
+        LOG_ERROR("No journal recorded");
+        return 1;
+    }
+    auto file = out_dir_path_ / "journal";
+    LOG_INFO("Writing analysis journal: ", file.string());
+    util::string2file(file, ctx_->journal_->serialize());
+    return 0;
+}
+
+std::string VrtlmodCore::get_journal_unit(const std::string &file) const
+{
+    AnalysisJournal ret;
+    if (ctx_->journal_)
+    {
+        std::string key = FileOverlay::get_key(file);
+        for (auto const &unit : ctx_->journal_->get_units())
+        {
+            if (unit.stage_ == ctx_->journal_->get_stage() && FileOverlay::get_key(unit.file_) == key)
+            {
+                ret.get_units().push_back(unit);
+            }
+        }
+    }
+    return ret.serialize();
+}
+
+int VrtlmodCore::replay_journal_unit(const std::string &data) const
+{
+    AnalysisJournal journal;
+    if (!journal.parse(data))
+    {
+        LOG_ERROR("Incomplete analysis journal unit");
+        return 1;
+    }
+    for (auto &unit : journal.get_units())
+    {
+        replay(unit, [](const std::string &path) { return path; });
+        if (ctx_->journal_)
+        {
+            ctx_->journal_->get_units().push_back(std::move(unit));
+        }
+    }
+    return 0;
+}
+
+void VrtlmodCore::replay(const AnalysisJournal::Unit &unit,
+                         const std::function<std::string(const std::string &path)> &remap) const
+{
+    for (auto const &e : unit.events_)
+    {
+        const auto &a = e.args_;
+        switch (e.kind_)
+        {
+        case AnalysisJournal::MODULE:
+            add_module(a.at(0), remap(a.at(1)), std::stoi(a.at(2)), std::stoi(a.at(3)));
+            break;
+        case AnalysisJournal::CELL:
+            add_cell(a.at(0), a.at(1), a.at(2), remap(a.at(3)), std::stoi(a.at(4)), std::stoi(a.at(5)));
+            break;
+        case AnalysisJournal::VARIABLE:
+            add_variable(a.at(0), a.at(1), a.at(2), a.at(3), remap(a.at(4)), std::stoi(a.at(5)), std::stoi(a.at(6)));
+            break;
+        case AnalysisJournal::TOP_CELL:
+            set_top_cell(a.at(0), a.at(1), a.at(2), a.at(3), remap(a.at(4)), std::stoi(a.at(5)), std::stoi(a.at(6)));
+            break;
+        case AnalysisJournal::INSTANCE:
+            add_or_defer_module_instance(a.at(0), a.at(1));
+            break;
+        case AnalysisJournal::INJECTION_LOCATION:
+            add_or_defer_injection_location(a.at(0), a.at(1), remap(a.at(2)), std::stoi(a.at(3)), std::stoi(a.at(4)));
+            break;
+        default:
+            LOG_FATAL("Unknown event [", std::string(1, e.kind_), "] in analysis journal");
+        }
+    }
+}
 
-        return var_iter->get();
+int VrtlmodCore::merge_shards(unsigned shard_count, const std::vector<std::string> &files, bool fused)
+{
+    std::vector<AnalysisJournal> journals(shard_count);
+    std::map<std::string, std::string> base_dirs; ///< normalized shard dir -> normalized output dir
+    std::string out_dir = FileOverlay::get_key(out_dir_path_.string());
+    for (unsigned i = 0; i < shard_count; ++i)
+    {
+        auto file = get_shard_dir(out_dir_path_, i) / "journal";
+        if (!fs::exists(file) || !journals[i].parse(util::file2string(file)))
+        {
+            LOG_ERROR("No complete analysis journal of shard ", std::to_string(i), " found at [", file.string(), "]");
+            return 1;
+        }
+        const AnalysisJournal &j = journals[i];
+        if (j.get_property("shard") != std::to_string(i) || j.get_property("shard_count") != std::to_string(shard_count))
+        {
+            LOG_ERROR("Journal [", file.string(), "] belongs to shard ", j.get_property("shard"), " of ",
+                      j.get_property("shard_count"), ", expected shard ", std::to_string(i), " of ",
+                      std::to_string(shard_count));
+            return 1;
+        }
+        if (j.get_property("fused") != (fused ? "1" : "0"))
+        {
+            LOG_ERROR("Journal [", file.string(), "] was recorded ", fused ? "without" : "with",
+                      " --fused-analysis. Merge with the options of the shards.");
+            return 1;
+        }
+        if (j.get_property("version") != VRTLMOD_VERSION)
+        {
+            LOG_WARNING("Journal [", file.string(), "] was written by vrtlmod version [", j.get_property("version"),
+                        "], this is [", VRTLMOD_VERSION, "]");
+        }
+        base_dirs[j.get_property("base_dir")] = out_dir;
     }
+
+    // the shards saw their private copies of the output directory
+    auto remap = [&](const std::string &path) -> std::string {
+        std::string key = FileOverlay::get_key(path);
+        for (auto const &it : base_dirs)
+        {
+            if (key.compare(0, it.first.size(), it.first) == 0 && key.size() > it.first.size() &&
+                key[it.first.size()] == '/')
+            {
+                return it.second + key.substr(it.first.size());
+            }
+        }
+        return path;
+    };
+
+    // units of a translation unit, keyed by stage and file name of the translation unit
+    std::map<std::pair<std::string, std::string>, std::vector<const AnalysisJournal::Unit *>> units;
+    size_t unit_count = 0;
+    for (auto const &j : journals)
+    {
+        for (auto const &unit : j.get_units())
+        {
+            units[std::make_pair(unit.stage_, fs::path(unit.file_).filename().string())].push_back(&unit);
+            ++unit_count;
+        }
+    }
+
+    size_t replayed = 0;
+    auto replay_stage = [&](const std::string &stage) {
+        for (auto const &file : files)
+        {
+            auto it = units.find(std::make_pair(stage, fs::path(file).filename().string()));
+            if (it == units.end())
+            {
+                continue;
+            }
+            for (auto const *unit : it->second)
+            {
+                replay(*unit, remap);
+                ++replayed;
+            }
+            units.erase(it);
+        }
+    };
+
+    if (fused)
+    {
+        defer_analysis();
+        replay_stage("fused");
+        resolve_deferred_analysis();
+    }
+    else
+    {
+        replay_stage("elaborate");
+        replay_stage("analyze");
+    }
+
+    if (replayed != unit_count)
+    {
+        LOG_ERROR("Analysis journals contain ", std::to_string(unit_count - replayed),
+                  " translation units that are not part of the input");
+        return 1;
+    }
+    if (ctx_->top_cell_ == nullptr)
+    {
+        LOG_ERROR("No top cell found in the analysis journals");
+        return 1;
+    }
+    LOG_INFO("Merged ", std::to_string(replayed), " translation units of ", std::to_string(shard_count), " shards");
+    return 0;
 }
 
 void VrtlmodCore::build_xml()
@@ -806,6 +1011,16 @@ void VrtlmodCore::build_xml()
     LOG_INFO("Writing VRTL Analysis XML: ", outfile.string());
     ctx_->xml_doc_->save_file(outfile.string().c_str());
 
+    auto dbfile = out_dir_path_ / top_name;
+    dbfile += "-vrtlmod.db";
+    LOG_INFO("Writing VRTL Analysis database: ", dbfile.string());
+    util::string2file(dbfile, analysisdb::serialize(*ctx_->xml_root_node_));
+
+    collect_injectable_targets();
+}
+
+void VrtlmodCore::collect_injectable_targets(void)
+{
     struct ListWalker : public pugi::xml_tree_walker
     {
         virtual bool for_each(pugi::xml_node &node) override
@@ -854,6 +1069,178 @@ void VrtlmodCore::build_xml()
     ctx_->xml_doc_->traverse(walker);
 }
 
+std::string VrtlmodCore::get_xml_string(void) const
+{
+    std::ostringstream ret;
+    ctx_->xml_doc_->save(ret);
+    return ret.str();
+}
+
+std::map<std::string, std::string> VrtlmodCore::get_analysis_fragments(void) const
+{
+    // file ids differ between runs if files are added or removed, so fragments use the paths
+    std::map<std::string, std::string> paths;
+    FileLocator::foreach_relevant_file([&](const auto &it) {
+        paths[util::concat("f", std::to_string(it.first))] = FileOverlay::get_key(it.second.string());
+    });
+    static const std::regex file_id("f[0-9]+(?=:l)");
+
+    std::map<std::string, std::set<std::string>> fragments;
+    auto add = [&](const std::string &locs, const std::string &fragment) {
+        for (std::sregex_iterator it(locs.begin(), locs.end(), file_id), end; it != end; ++it)
+        {
+            auto path = paths.find(it->str());
+            if (path != paths.end())
+            {
+                fragments[path->second].insert(fragment);
+            }
+        }
+    };
+    auto resolve = [&](const std::string &locs) {
+        std::string ret;
+        auto last = locs.cbegin();
+        for (std::sregex_iterator it(locs.begin(), locs.end(), file_id), end; it != end; ++it)
+        {
+            auto path = paths.find(it->str());
+            ret.append(last, (*it)[0].first).append(path != paths.end() ? path->second : it->str());
+            last = (*it)[0].second;
+        }
+        return ret.append(last, locs.cend());
+    };
+
+    for (auto const &it : ctx_->modules_)
+    {
+        add(it->get_decl_loc(), util::concat("module ", it->get_id(), " ", resolve(it->get_decl_loc())));
+    }
+    foreach_injection_target([&](const types::Target &t) {
+        std::string fragment =
+            util::concat("target ", types::Module(t.parent()).get_id(), " ", t.get_id(), " ", t.get_type(), " ",
+                         t.get_cxx_type(), " ", t.get_bases(), " ", t.get_dimensions(), " ",
+                         std::to_string(t.get_bits()), " ", resolve(t.get_decl_loc()), " ", resolve(t.get_inj_loc()));
+        add(t.get_decl_loc(), fragment);
+        add(t.get_inj_loc(), fragment);
+        return true;
+    });
+
+    std::map<std::string, std::string> ret;
+    for (auto const &it : fragments)
+    {
+        std::string &fragment = ret[it.first];
+        for (auto const &line : it.second)
+        {
+            fragment = util::concat(fragment, line, "\n");
+        }
+    }
+    return ret;
+}
+
+fs::path VrtlmodCore::get_snapshot_dir(void) const
+{
+    return out_dir_path_ / ".vrtlmod-snapshot";
+}
+
+void VrtlmodCore::save_analysis_snapshot(const std::vector<std::string> &files) const
+{
+    auto dir = get_snapshot_dir();
+    if (!fs::is_directory(dir))
+    {
+        fs::create_directories(dir);
+    }
+    LOG_INFO("Writing analysis snapshot: ", dir.string());
+    for (auto const &it : files)
+    {
+        util::string2file(dir / fs::path(it).filename(), FileOverlay::get().read(it));
+    }
+
+    // symbol table instances are not part of the XML
+    std::string instances;
+    for (auto const &m : ctx_->modules_)
+    {
+        for (auto const &i : m->symboltable_instances_)
+        {
+            instances = util::concat(instances, m->get_id(), " ", i, "\n");
+        }
+    }
+    util::string2file(dir / "instances", instances);
+}
+
+int VrtlmodCore::load_analysis(const std::string &xml_file, const std::vector<std::string> &files)
+{
+    auto dir = get_snapshot_dir();
+    if (!fs::is_directory(dir))
+    {
+        LOG_ERROR("No analysis snapshot found at [", dir.string(),
+                  "]. Run a full analysis with --save-snapshot first.");
+        return 1;
+    }
+
+    auto doc = std::make_unique<pugi::xml_document>();
+    pugi::xml_parse_result result = doc->load_file(xml_file.c_str());
+    if (!result)
+    {
+        LOG_ERROR("XML [", xml_file, "] parsed with errors\n", "\tError description: ", result.description(), "\n",
+                  "\tError offset: ", std::to_string(result.offset));
+        return 1;
+    }
+    auto root = doc->child("vrtlmod_xml");
+    if (std::string(root.attribute("version").value()) != VRTLMOD_VERSION)
+    {
+        LOG_WARNING("XML [", xml_file, "] was written by vrtlmod version [", root.attribute("version").value(),
+                    "], this is [", VRTLMOD_VERSION, "]");
+    }
+
+    ctx_->xml_doc_ = std::move(doc);
+    ctx_->xml_root_node_ = std::make_unique<pugi::xml_node>(root);
+    ctx_->xml_netlist_node_ = std::make_unique<pugi::xml_node>(root.child("top"));
+    ctx_->xml_modules_node_ = std::make_unique<pugi::xml_node>(root.child("modules"));
+    ctx_->xml_files_node_ = std::make_unique<pugi::xml_node>(root.child("files"));
+
+    set_top_cell(ctx_->xml_netlist_node_->child("cell"));
+    for (auto const &m : ctx_->xml_modules_node_->children("module"))
+    {
+        types::Module *module = register_module(std::make_unique<types::Module>(m));
+        for (auto const &x : m.children())
+        {
+            std::string name = x.name();
+            if (name == "cell")
+            {
+                register_cell(*module, std::make_unique<types::Cell>(x));
+            }
+            else if ((name == "var") || (name == "in") || (name == "out") || (name == "inout"))
+            {
+                register_variable(*module, std::make_unique<types::Variable>(x));
+            }
+        }
+    }
+
+    std::istringstream instances(util::file2string(dir / "instances"));
+    std::string module_id, instance;
+    while (instances >> module_id >> instance)
+    {
+        if (add_module_instance(module_id, instance) == nullptr)
+        {
+            LOG_WARNING("{instance}: [", instance, "] no matching module [", module_id, "] found in XML.");
+        }
+    }
+
+    collect_injectable_targets();
+
+    // restore the sources as they were analyzed
+    for (auto const &it : files)
+    {
+        auto snapshot = dir / fs::path(it).filename();
+        if (!fs::exists(snapshot))
+        {
+            LOG_ERROR("File [", it,
+                      "] is not part of the analysis snapshot. Run a full analysis with --save-snapshot first.");
+            return 1;
+        }
+        FileOverlay::get().write(it, util::file2string(snapshot));
+    }
+    LOG_INFO("Loaded analysis from [", xml_file, "] and ", std::to_string(files.size()), " files from snapshot");
+    return 0;
+}
+
 int VrtlmodCore::build_api(void)
 {
     return gen_->build_api();
@@ -881,11 +1268,29 @@ struct WhiteListFilter : public Filter, public pugi::xml_tree_walker
     std::set<const types::Target *> apply(const VrtlmodCore *core) override;
     const VrtlmodCore *core_{ nullptr };
     fs::path fpath_;
+    std::unordered_map<std::string, const types::Target *> injectables_; ///< Variable::get_key() -> injectable
     WhiteListFilter(fs::path fpath) : fpath_(fpath) {}
     virtual ~WhiteListFilter(void) {}
 };
 
-int VrtlmodCore::initialize_injection_targets(std::string file)
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \class PatternFilter
+/// \brief Filters the targets of another filter by `<module id>::<signal id>` patterns
+/// \details Patterns are globs (`*`, `?`, `[...]`), or regular expressions if prefixed with `re:`. A target remains if
+///          it matches any pattern.
+struct PatternFilter : public Filter
+{
+    std::unique_ptr<Filter> base_; ///< provides the candidates
+    std::vector<llvm::GlobPattern> globs_;
+    std::vector<llvm::Regex> regexes_;
+
+    bool matches(const std::string &key);
+    std::set<const types::Target *> apply(const VrtlmodCore *core) override;
+    PatternFilter(std::unique_ptr<Filter> base, const std::vector<std::string> &patterns);
+    virtual ~PatternFilter(void) {}
+};
+
+int VrtlmodCore::initialize_injection_targets(std::string file, const std::vector<std::string> &patterns)
 {
     std::unique_ptr<Filter> filter;
     // check for valid file
@@ -901,6 +1306,10 @@ int VrtlmodCore::initialize_injection_targets(std::string file)
         // we've got a whitelist file to filter our injectables with:
         filter = std::make_unique<WhiteListFilter>(fpath);
     }
+    if (!patterns.empty())
+    {
+        filter = std::make_unique<PatternFilter>(std::move(filter), patterns);
+    }
 
     apply_target_filter(std::move(filter));
 
@@ -913,16 +1322,7 @@ int VrtlmodCore::initialize_injection_targets(std::string file)
     std::set<const types::Target *> removed{};
     for (const auto &injectable : ctx_->injectable_targets_)
     {
-        bool rem = true;
-        for (const auto &injecting : ctx_->toinj_targets_)
-        {
-            if (injecting == injectable)
-            {
-                rem = false;
-                break;
-            }
-        }
-        if (rem)
+        if (ctx_->toinj_targets_.count(injectable) == 0)
             removed.insert(injectable.get());
     }
 
@@ -941,15 +1341,15 @@ int VrtlmodCore::initialize_injection_targets(std::string file)
 void VrtlmodCore::apply_target_filter(std::unique_ptr<Filter> filter) const
 {
     auto targets = filter->apply(this);
+    std::unordered_set<std::string> keys;
+    for (const auto &v : targets)
+    {
+        keys.insert(types::Variable(static_cast<pugi::xml_node>(*v)).get_key());
+    }
     auto func = [&](const types::Target &it) {
-        for (const auto &v : targets)
+        if (keys.count(it.get_key()) != 0)
         {
-            types::Variable _v(static_cast<pugi::xml_node>(*v));
-            if (_v == it)
-            {
-                add_injection_target(it);
-                break; // target found can leave current it-eration
-            }
+            add_injection_target(it);
         }
         return true; // continue loop thorugh injectables
     };
@@ -1017,17 +1417,12 @@ bool WhiteListFilter::for_each(pugi::xml_node &node)
                 }
             }
 
-            types::Variable v(node);
-            auto func = [&](const types::Target &t) {
-                if (v == t)
-                {
-                    LOG_VERBOSE(">> adding [", t._self(), "] to injection targets.");
-                    targets_.insert(&t);
-                    return false;
-                }
-                return true;
-            };
-            core_->foreach_injectable(func);
+            auto it = injectables_.find(types::Variable(node).get_key());
+            if (it != injectables_.end())
+            {
+                LOG_VERBOSE(">> adding [", it->second->_self(), "] to injection targets.");
+                targets_.insert(it->second);
+            }
         }
     }
     return true;
@@ -1049,12 +1444,72 @@ std::set<const types::Target *> WhiteListFilter::apply(const VrtlmodCore *core)
     {
         LOG_INFO("Filter found. Filtering injectables by whitelisting.");
         core_ = core;
+        core_->foreach_injectable([&](const types::Target &t) {
+            injectables_.emplace(t.get_key(), &t); // first match wins
+            return true;
+        });
         doc.traverse(*this);
     }
 
     return targets_;
 }
 
+PatternFilter::PatternFilter(std::unique_ptr<Filter> base, const std::vector<std::string> &patterns)
+    : base_(std::move(base))
+{
+    for (auto const &it : patterns)
+    {
+        if (it.rfind("re:", 0) == 0)
+        {
+            llvm::Regex regex(util::concat("^(", it.substr(3), ")$"));
+            std::string err;
+            if (!regex.isValid(err))
+            {
+                LOG_FATAL("Invalid target pattern [", it, "]: ", err);
+            }
+            regexes_.push_back(std::move(regex));
+        }
+        else
+        {
+            auto glob = llvm::GlobPattern::create(it);
+            if (!glob)
+            {
+                LOG_FATAL("Invalid target pattern [", it, "]: ", llvm::toString(glob.takeError()));
+            }
+            globs_.push_back(std::move(*glob));
+        }
+    }
+}
+
+bool PatternFilter::matches(const std::string &key)
+{
+    for (auto const &it : globs_)
+    {
+        if (it.match(key))
+            return true;
+    }
+    for (auto const &it : regexes_)
+    {
+        if (it.match(key))
+            return true;
+    }
+    return false;
+}
+
+std::set<const types::Target *> PatternFilter::apply(const VrtlmodCore *core)
+{
+    LOG_INFO("Filtering injection targets by ", std::to_string(globs_.size() + regexes_.size()), " patterns.");
+    for (auto const &t : base_->apply(core))
+    {
+        if (matches(get_member_key(t->get_parent().get_id(), t->get_id())))
+        {
+            LOG_VERBOSE(">> adding [", t->_self(), "] to injection targets.");
+            targets_.insert(t);
+        }
+    }
+    return targets_;
+}
+
 void VrtlmodCore::foreach_signal(const std::function<bool(const types::Target &t)> &func) const
 {
     for (const auto &it : ctx_->signals_)
@@ -1106,15 +1561,49 @@ void VrtlmodCore::foreach_cell(const std::function<bool(const types::Cell &)> &f
 
 const types::Module *VrtlmodCore::get_module_from_cell(const types::Cell &c) const
 {
-    std::set<std::unique_ptr<types::Module>>::iterator mod_iter;
-    auto cell_type = c.get_type();
-    mod_iter = std::find_if(ctx_->modules_.begin(), ctx_->modules_.end(),
-                            [cell_type](const auto &it) { return cell_type == it->get_id(); });
-    if (mod_iter != ctx_->modules_.end())
-    {
-        return (*mod_iter).get();
-    }
-    return nullptr;
+    return find_module(c.get_type());
+}
+
+types::Module *VrtlmodCore::find_module(const std::string &module_id) const
+{
+    auto it = ctx_->module_index_.find(module_id);
+    return (it != ctx_->module_index_.end()) ? it->second : nullptr;
+}
+
+types::Variable *VrtlmodCore::find_variable(const std::string &module_id, const std::string &var_id) const
+{
+    auto it = ctx_->variable_index_.find(get_member_key(module_id, var_id));
+    return (it != ctx_->variable_index_.end()) ? it->second : nullptr;
+}
+
+types::Cell *VrtlmodCore::find_cell(const std::string &module_id, const std::string &cell_id) const
+{
+    auto it = ctx_->cell_index_.find(get_member_key(module_id, cell_id));
+    return (it != ctx_->cell_index_.end()) ? it->second : nullptr;
+}
+
+types::Module *VrtlmodCore::register_module(std::unique_ptr<types::Module> module) const
+{
+    types::Module *ret = module.get();
+    ctx_->module_index_.emplace(ret->get_id(), ret);
+    ctx_->modules_.insert(std::move(module));
+    return ret;
+}
+
+types::Variable *VrtlmodCore::register_variable(types::Module &module, std::unique_ptr<types::Variable> var) const
+{
+    types::Variable *ret = var.get();
+    ctx_->variable_index_.emplace(get_member_key(module.get_id(), ret->get_id()), ret);
+    module.add_variable(std::move(var));
+    return ret;
+}
+
+types::Cell *VrtlmodCore::register_cell(types::Module &module, std::unique_ptr<types::Cell> cell) const
+{
+    types::Cell *ret = cell.get();
+    ctx_->cell_index_.emplace(get_member_key(module.get_id(), ret->get_id()), ret);
+    module.add_cell(std::move(cell));
+    return ret;
 }
 
 std::set<std::shared_ptr<types::Target>> &VrtlmodCore::get_signals(void) const
@@ -1132,6 +1621,11 @@ std::set<std::shared_ptr<types::Target>> &VrtlmodCore::get_injectable_targets(vo
     return (ctx_->injectable_targets_);
 }
 
+bool VrtlmodCore::is_input_file(const std::string &file) const
+{
+    return ctx_->input_files_.find(FileOverlay::get_key(file)) != ctx_->input_files_.end();
+}
+
 void VrtlmodCore::add_parsed_file(fs::path fpath) const
 {
     ctx_->parsed_files_.insert(fpath);
@@ -1145,6 +1639,7 @@ void VrtlmodCore::add_injectable_target(std::shared_ptr<types::Target> t) const
 void VrtlmodCore::add_injection_target(std::shared_ptr<types::Target> t) const
 {
     ctx_->toinj_targets_.insert(t);
+    ctx_->toinj_index_valid_ = false;
 }
 
 void VrtlmodCore::add_injection_target(const types::Target &t) const
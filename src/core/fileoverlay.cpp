@@ -0,0 +1,223 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file fileoverlay.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/fileoverlay.hpp"
+#include "vrtlmod/util/logging.hpp"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace vrtlmod
+{
+
+namespace
+{
+////////////////////////////////////////////////////////////////////////////////
+/// @brief File of the overlay, opened with the content it had at open time
+class OverlayFile : public llvm::vfs::File
+{
+    llvm::vfs::Status status_;
+    std::shared_ptr<const std::string> content_;
+
+  public:
+    OverlayFile(llvm::vfs::Status status, std::shared_ptr<const std::string> content)
+        : status_(std::move(status)), content_(std::move(content))
+    {
+    }
+    llvm::ErrorOr<llvm::vfs::Status> status(void) override { return status_; }
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> getBuffer(const llvm::Twine &name, int64_t file_size,
+                                                                 bool requires_null_terminator,
+                                                                 bool is_volatile) override
+    {
+        return llvm::MemoryBuffer::getMemBufferCopy(*content_, name);
+    }
+    std::error_code close(void) override { return {}; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Shows the current content of the FileOverlay instead of the files of the underlying file system
+/// @details Directory listings, real paths and all files not held in memory are served by the underlying file system.
+///          Overlay files keep the identity (UniqueID) of their file on disk.
+class OverlayFileSystem : public llvm::vfs::ProxyFileSystem
+{
+    FileOverlay &overlay_;
+
+    std::string get_key(const llvm::Twine &path) const
+    {
+        llvm::SmallString<256> abs_path;
+        path.toVector(abs_path);
+        makeAbsolute(abs_path); // relative to the working directory of the tool
+        return FileOverlay::get_key(abs_path.str().str());
+    }
+
+    llvm::vfs::Status get_status(const llvm::Twine &path, const std::string &content)
+    {
+        auto st = ProxyFileSystem::status(path);
+        if (!st)
+        {
+            return llvm::vfs::Status(path.str(), llvm::vfs::getNextVirtualUniqueID(), llvm::sys::TimePoint<>(), 0, 0,
+                                     content.size(), llvm::sys::fs::file_type::regular_file, llvm::sys::fs::all_read);
+        }
+        return llvm::vfs::Status(st->getName(), st->getUniqueID(), st->getLastModificationTime(), st->getUser(),
+                                 st->getGroup(), content.size(), st->getType(), st->getPermissions());
+    }
+
+  public:
+    OverlayFileSystem(llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> base, FileOverlay &overlay)
+        : ProxyFileSystem(std::move(base)), overlay_(overlay)
+    {
+    }
+    llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine &path) override
+    {
+        if (auto content = overlay_.lookup(get_key(path)))
+        {
+            return get_status(path, *content);
+        }
+        return ProxyFileSystem::status(path);
+    }
+    llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> openFileForRead(const llvm::Twine &path) override
+    {
+        if (auto content = overlay_.lookup(get_key(path)))
+        {
+            return std::unique_ptr<llvm::vfs::File>(new OverlayFile(get_status(path, *content), content));
+        }
+        return ProxyFileSystem::openFileForRead(path);
+    }
+};
+} // namespace
+
+FileOverlay &FileOverlay::get(void)
+{
+    static FileOverlay overlay;
+    return overlay;
+}
+
+std::string FileOverlay::get_key(const std::string &file)
+{
+    llvm::SmallString<256> path(file);
+    llvm::sys::fs::make_absolute(path);
+    llvm::sys::path::remove_dots(path, true);
+    return path.str().str();
+}
+
+void FileOverlay::enable(void)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    enabled_ = true;
+}
+
+bool FileOverlay::is_enabled(void) const
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    return enabled_;
+}
+
+std::shared_ptr<const std::string> FileOverlay::lookup(const std::string &file) const
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    auto it = files_.find(file);
+    return (it != files_.end()) ? it->second : nullptr;
+}
+
+std::string FileOverlay::read(const fs::path &file) const
+{
+    if (auto content = lookup(get_key(file.string())))
+    {
+        return *content;
+    }
+    return util::file2string(file);
+}
+
+bool FileOverlay::exists(const fs::path &file) const
+{
+    return lookup(get_key(file.string())) || fs::exists(file);
+}
+
+void FileOverlay::write(const fs::path &file, std::string content)
+{
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (enabled_)
+        {
+            std::string key = get_key(file.string());
+            files_[key] = std::make_shared<const std::string>(std::move(content));
+            dirty_.insert(key);
+            return;
+        }
+    }
+    util::string2file(file, content);
+}
+
+void FileOverlay::write(const fs::path &file, const std::function<void(llvm::raw_ostream &)> &producer)
+{
+    if (is_enabled())
+    {
+        std::string content;
+        llvm::raw_string_ostream os(content);
+        producer(os);
+        os.flush();
+        write(file, std::move(content));
+        return;
+    }
+
+    // stream to a temporary next to the target and move it in place, the target may still be mapped by its reader
+    fs::path tmp_path = util::get_replacement_path(file);
+    {
+        std::error_code ec;
+        llvm::raw_fd_ostream os(tmp_path.string(), ec);
+        if (ec)
+        {
+            LOG_FATAL("FileOverlay::write(): Could not create file at [", tmp_path.string(), "]: ", ec.message());
+        }
+        producer(os);
+    }
+    util::replace_file(tmp_path, file);
+}
+
+llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>
+FileOverlay::create_vfs(llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> base)
+{
+    if (!is_enabled())
+    {
+        return base;
+    }
+    return llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>(new OverlayFileSystem(std::move(base), *this));
+}
+
+void FileOverlay::flush(void)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (dirty_.empty())
+    {
+        return;
+    }
+    LOG_INFO("Writing ", std::to_string(dirty_.size()), " files from memory");
+    for (auto const &it : dirty_)
+    {
+        util::string2file(it, *files_.at(it));
+    }
+    dirty_.clear();
+}
+
+} // namespace vrtlmod
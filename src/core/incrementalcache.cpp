@@ -0,0 +1,274 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file incrementalcache.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/incrementalcache.hpp"
+#include "vrtlmod/core/fileoverlay.hpp"
+#include "vrtlmod/util/logging.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace vrtlmod
+{
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Returns the prerequisites of a make rule written by clang -MD -MF, relative paths are resolved against dir
+std::vector<std::string> parse_dependency_file(const std::string &data, const fs::path &dir)
+{
+    std::vector<std::string> ret;
+    size_t pos = data.find(": ");
+    if (pos == std::string::npos)
+    {
+        return ret;
+    }
+    std::string dep;
+    auto push = [&]() {
+        if (dep != "")
+        {
+            fs::path dep_path(dep);
+            ret.push_back(FileOverlay::get_key(dep_path.is_absolute() ? dep : (dir / dep_path).string()));
+            dep.clear();
+        }
+    };
+    for (pos += 2; pos < data.size(); ++pos)
+    {
+        char c = data[pos];
+        if (c == '\\' && pos + 1 < data.size() && (data[pos + 1] == '\n' || data[pos + 1] == ' '))
+        {
+            // line continuation or escaped space
+            if (data[++pos] == ' ')
+            {
+                dep += ' ';
+            }
+            else
+            {
+                push();
+            }
+        }
+        else if (c == '$' && pos + 1 < data.size() && data[pos + 1] == '$')
+        {
+            dep += '$';
+            ++pos;
+        }
+        else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+        {
+            push();
+        }
+        else
+        {
+            dep += c;
+        }
+    }
+    push();
+    return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Entry key of a base key and the content hashes of the dependencies
+template <typename HashFunc>
+std::string get_entry(const std::string &stage, const std::string &base, const std::vector<std::string> &deps,
+                      HashFunc &&get_hash)
+{
+    std::string key = base;
+    for (auto const &dep : deps)
+    {
+        key = util::concat(key, "\n", dep, "\n", get_hash(dep));
+    }
+    return util::concat(stage, "-", util::hash_str(key));
+}
+
+} // namespace
+
+IncrementalCache::IncrementalCache(const fs::path &dir, const std::string &salt) : dir_(dir), salt_(salt)
+{
+    if (!fs::is_directory(dir_))
+    {
+        LOG_INFO("Creating cache directory [", dir_.string(), "]");
+        fs::create_directories(dir_);
+    }
+}
+
+fs::path IncrementalCache::get_dependency_file(const std::string &file) const
+{
+    return dir_ / util::concat("deps-", util::hash_str(FileOverlay::get_key(file)), ".d");
+}
+
+const std::string &IncrementalCache::get_hash(const std::string &stage, const std::string &file)
+{
+    auto &hashes = hashes_[stage];
+    auto it = hashes.find(file);
+    if (it == hashes.end())
+    {
+        // files no stage changes, e.g., the Verilator runtime headers, may be missing on later runs
+        std::string hash = FileOverlay::get().exists(file) ? util::hash_str(FileOverlay::get().read(file)) : "-";
+        it = hashes.emplace(file, hash).first;
+    }
+    return it->second;
+}
+
+std::string IncrementalCache::lookup(const std::string &stage, const std::string &file, const context_t &context)
+{
+    std::string base = util::hash_str(util::concat(salt_, "\n", stage, "\n",
+                                                   util::hash_str(context ? context(file) : std::string()), "\n",
+                                                   file, "\n", get_hash(stage, file)));
+    fs::path manifest = dir_ / util::concat(stage, "-", base, ".deps");
+    if (fs::exists(manifest))
+    {
+        std::vector<std::string> deps;
+        std::istringstream in(util::file2string(manifest));
+        for (std::string dep; std::getline(in, dep);)
+        {
+            deps.push_back(dep);
+        }
+        std::string entry = get_entry(stage, base, deps, [&](const std::string &dep) { return get_hash(stage, dep); });
+        if (fs::exists(dir_ / entry))
+        {
+            used_.insert(manifest.filename().string());
+            used_.insert(entry);
+            return entry;
+        }
+    }
+    pending_[stage].push_back(std::make_pair(file, base));
+    return "";
+}
+
+void IncrementalCache::put(const std::string &stage, const std::string &file, const std::string &base,
+                           const std::string &data)
+{
+    fs::path dependency_file = get_dependency_file(file);
+    if (!fs::exists(dependency_file))
+    {
+        LOG_VERBOSE("{cache}: no dependency file for [", file, "], ", stage, " result not stored");
+        return;
+    }
+    std::vector<std::string> deps =
+        parse_dependency_file(util::file2string(dependency_file), fs::path(file).parent_path());
+
+    fs::path manifest = dir_ / util::concat(stage, "-", base, ".deps");
+    std::string entry = get_entry(stage, base, deps, [&](const std::string &dep) { return get_hash(stage, dep); });
+    std::string deps_str;
+    for (auto const &dep : deps)
+    {
+        deps_str = util::concat(deps_str, dep, "\n");
+    }
+    util::string2file(manifest, deps_str);
+    util::string2file(dir_ / entry, data);
+    used_.insert(manifest.filename().string());
+    used_.insert(entry);
+}
+
+std::vector<std::string> IncrementalCache::restore(const std::string &stage, const std::vector<std::string> &files,
+                                                   const context_t &context)
+{
+    std::vector<std::string> ret;
+    pending_[stage].clear();
+    restored_[stage].clear();
+    hashes_[stage].clear();
+    stages_.insert(stage);
+
+    // the entry keys use the content before the stage, also for files another file of the stage includes
+    for (auto const &file : files)
+    {
+        get_hash(stage, file);
+    }
+    for (auto const &file : files)
+    {
+        std::string entry = lookup(stage, file, context);
+        if (entry != "")
+        {
+            restored_[stage].push_back(std::make_pair(file, dir_ / entry));
+            ++hits_;
+        }
+        else
+        {
+            ret.push_back(file);
+            ++misses_;
+        }
+    }
+    LOG_INFO("{cache}: ", std::to_string(files.size() - ret.size()), " of ", std::to_string(files.size()),
+             " files restored for ", stage);
+    return ret;
+}
+
+void IncrementalCache::store(const std::string &stage)
+{
+    for (auto const &it : restored_[stage])
+    {
+        LOG_VERBOSE("{cache}: [", it.first, "] unchanged, restored result of ", stage);
+        FileOverlay::get().write(it.first, util::file2string(it.second));
+    }
+    for (auto const &it : pending_[stage])
+    {
+        put(stage, it.first, it.second, FileOverlay::get().read(it.first));
+    }
+    restored_.erase(stage);
+    pending_.erase(stage);
+}
+
+bool IncrementalCache::load(const std::string &stage, const std::string &file, std::string &data,
+                            const context_t &context)
+{
+    stages_.insert(stage);
+    std::string entry = lookup(stage, file, context);
+    if (entry == "")
+    {
+        ++misses_;
+        return false;
+    }
+    LOG_VERBOSE("{cache}: [", file, "] unchanged, restored result of ", stage);
+    data = util::file2string(dir_ / entry);
+    ++hits_;
+    return true;
+}
+
+void IncrementalCache::save(const std::string &stage, const std::string &file, const std::string &data)
+{
+    auto &pending = pending_[stage];
+    auto it = std::find_if(pending.begin(), pending.end(), [&](const auto &x) { return x.first == file; });
+    if (it != pending.end())
+    {
+        put(stage, it->first, it->second, data);
+        pending.erase(it);
+    }
+}
+
+void IncrementalCache::prune(void)
+{
+    std::vector<fs::path> stale;
+    for (auto const &it : fs::directory_iterator(dir_))
+    {
+        std::string entry = it.path().filename().string();
+        std::string stage = entry.substr(0, entry.rfind('-'));
+        if ((stages_.find(stage) != stages_.end()) && (used_.find(entry) == used_.end()))
+        {
+            stale.push_back(it.path());
+        }
+    }
+    for (auto const &it : stale)
+    {
+        LOG_VERBOSE("{cache}: remove stale entry [", it.string(), "]");
+        fs::remove(it);
+    }
+}
+
+} // namespace vrtlmod
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file journal.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/journal.hpp"
+
+#include <cstdlib>
+
+namespace vrtlmod
+{
+
+namespace
+{
+constexpr const char *MAGIC = "vrtlmod-journal-1";
+
+// fields are written as `<length>:<bytes>\n`, so they may contain any character, e.g., multi-line declarations
+void write_field(std::string &out, const std::string &field)
+{
+    out.append(std::to_string(field.size())).append(":").append(field).push_back('\n');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Reads the fields written by write_field()
+class FieldReader
+{
+    const std::string &data_;
+    size_t pos_{ 0 };
+    bool ok_{ true };
+
+  public:
+    FieldReader(const std::string &data) : data_(data) {}
+    bool ok(void) const { return ok_; }
+    bool at_end(void) const { return pos_ >= data_.size(); }
+    std::string next(void)
+    {
+        auto colon = data_.find(':', pos_);
+        if (!ok_ || colon == std::string::npos)
+        {
+            ok_ = false;
+            return "";
+        }
+        char *end = nullptr;
+        size_t len = std::strtoul(data_.c_str() + pos_, &end, 10);
+        if (end != data_.c_str() + colon || colon + 1 + len >= data_.size() || data_[colon + 1 + len] != '\n')
+        {
+            ok_ = false;
+            return "";
+        }
+        pos_ = colon + 2 + len;
+        return data_.substr(colon + 1, len);
+    }
+    size_t next_count(void)
+    {
+        std::string str = next();
+        char *end = nullptr;
+        size_t ret = std::strtoul(str.c_str(), &end, 10);
+        if (str.empty() || *end != '\0')
+        {
+            ok_ = false;
+        }
+        return ret;
+    }
+};
+} // namespace
+
+std::string AnalysisJournal::get_property(const std::string &key) const
+{
+    auto it = properties_.find(key);
+    return (it != properties_.end()) ? it->second : "";
+}
+
+void AnalysisJournal::record(const std::string &file, Kind kind, std::vector<std::string> args)
+{
+    // events of a translation unit are contiguous, since units enter the core one after another
+    if (units_.empty() || units_.back().stage_ != stage_ || units_.back().file_ != file)
+    {
+        units_.push_back(Unit{ stage_, file, {} });
+    }
+    units_.back().events_.push_back(Event{ kind, std::move(args) });
+}
+
+std::string AnalysisJournal::serialize(void) const
+{
+    std::string ret;
+    write_field(ret, MAGIC);
+    write_field(ret, std::to_string(properties_.size()));
+    for (auto const &it : properties_)
+    {
+        write_field(ret, it.first);
+        write_field(ret, it.second);
+    }
+    write_field(ret, std::to_string(units_.size()));
+    for (auto const &unit : units_)
+    {
+        write_field(ret, unit.stage_);
+        write_field(ret, unit.file_);
+        write_field(ret, std::to_string(unit.events_.size()));
+        for (auto const &event : unit.events_)
+        {
+            write_field(ret, std::string(1, event.kind_));
+            write_field(ret, std::to_string(event.args_.size()));
+            for (auto const &arg : event.args_)
+            {
+                write_field(ret, arg);
+            }
+        }
+    }
+    write_field(ret, "end");
+    return ret;
+}
+
+bool AnalysisJournal::parse(const std::string &data)
+{
+    FieldReader in(data);
+    properties_.clear();
+    units_.clear();
+    if (in.next() != MAGIC)
+    {
+        return false;
+    }
+    for (size_t n = in.next_count(); in.ok() && n > 0; --n)
+    {
+        std::string key = in.next();
+        properties_[key] = in.next();
+    }
+    for (size_t n = in.next_count(); in.ok() && n > 0; --n)
+    {
+        Unit unit;
+        unit.stage_ = in.next();
+        unit.file_ = in.next();
+        for (size_t e = in.next_count(); in.ok() && e > 0; --e)
+        {
+            std::string kind = in.next();
+            Event event{ kind.empty() ? Kind(0) : Kind(kind[0]), {} };
+            for (size_t a = in.next_count(); in.ok() && a > 0; --a)
+            {
+                event.args_.push_back(in.next());
+            }
+            unit.events_.push_back(std::move(event));
+        }
+        units_.push_back(std::move(unit));
+    }
+    return in.next() == "end" && in.ok() && in.at_end();
+}
+
+} // namespace vrtlmod
@@ -0,0 +1,468 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file toolrunner.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/toolrunner.hpp"
+#include "vrtlmod/core/astcache.hpp"
+#include "vrtlmod/core/fileoverlay.hpp"
+#include "vrtlmod/util/logging.hpp"
+#include "vrtlmod/util/timereport.hpp"
+#include "vrtlmod/util/utility.hpp"
+
+#include "clang/Rewrite/Core/Rewriter.h"
+#include "clang/Tooling/Tooling.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace vrtlmod
+{
+
+namespace
+{
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Turnstile letting TUs of a parallel run enter their shared-state section in input order
+struct Sequencer
+{
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    size_t next_{ 0 }; ///< index of the TU that may currently enter
+
+    void wait(size_t idx)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait(lock, [&] { return next_ == idx; });
+    }
+    void release(size_t idx)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait(lock, [&] { return next_ == idx; }); // TUs that failed before entering still keep their place
+            ++next_;
+        }
+        cv_.notify_all();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Per-worker reference to the TU currently processed by this thread
+struct Ticket
+{
+    Sequencer *seq_{ nullptr };
+    size_t idx_{ 0 };
+    bool entered_{ false };
+};
+thread_local Ticket ticket;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Files written by TUs of an isolated run, flushed at its end
+struct DeferredWrites
+{
+    std::mutex mtx_;
+    bool active_{ false };
+    std::map<std::string, std::string> files_; ///< path -> content
+    std::map<std::string, fs::path> streamed_;  ///< path -> temporary holding its content, see ToolRunner::write_file()
+
+    void flush(bool write)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (write)
+        {
+            for (auto const &it : files_)
+            {
+                FileOverlay::get().write(it.first, it.second);
+            }
+            for (auto const &it : streamed_)
+            {
+                util::replace_file(it.second, it.first);
+            }
+        }
+        else
+        {
+            for (auto const &it : streamed_)
+            {
+                fs::remove(it.second);
+            }
+        }
+        files_.clear();
+        streamed_.clear();
+        active_ = false;
+    }
+} deferred_writes;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Activates deferred writes for the lifetime of an isolated run
+struct IsolationGuard
+{
+    bool isolated_;
+    IsolationGuard(bool isolated) : isolated_(isolated)
+    {
+        if (isolated_)
+        {
+            std::unique_lock<std::mutex> lock(deferred_writes.mtx_);
+            deferred_writes.active_ = true;
+        }
+    }
+    ~IsolationGuard(void)
+    {
+        if (isolated_)
+        {
+            deferred_writes.flush(std::uncaught_exceptions() == 0); // failed runs leave files untouched
+        }
+    }
+};
+
+int merge_result(int a, int b)
+{
+    // ClangTool::run(): 1 on failed TUs dominates 2 on skipped TUs dominates 0
+    if (a == 1 || b == 1)
+        return 1;
+    return std::max(a, b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Calls func(idx) for all idx < n on a pool of workers. Re-throws the first failure in index order
+void parallel_for(size_t n, unsigned workers, const std::function<void(size_t)> &func)
+{
+    std::atomic<size_t> next{ 0 };
+    std::atomic<bool> abort{ false };
+    std::vector<std::exception_ptr> errors(n);
+
+    auto worker = [&]() {
+        for (size_t idx = next++; idx < n && !abort; idx = next++)
+        {
+            try
+            {
+                func(idx);
+            }
+            catch (...)
+            {
+                errors[idx] = std::current_exception();
+                abort = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        pool.emplace_back(worker);
+    }
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+    for (auto const &e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+}
+} // namespace
+
+ToolRunner::ToolRunner(const clang::tooling::CompilationDatabase &compilations, unsigned jobs, adjuster_t adjuster)
+    : compilations_(compilations), jobs_(jobs), adjuster_(adjuster)
+{
+    if (jobs_ == 0)
+    {
+        jobs_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void ToolRunner::write_changes(clang::Rewriter &rewriter)
+{
+    std::unique_lock<std::mutex> lock(deferred_writes.mtx_);
+    bool in_memory = FileOverlay::get().is_enabled();
+    if (!deferred_writes.active_ && !in_memory)
+    {
+        rewriter.overwriteChangedFiles();
+        return;
+    }
+
+    const clang::SourceManager &sm = rewriter.getSourceMgr();
+    for (auto it = rewriter.buffer_begin(); it != rewriter.buffer_end(); ++it)
+    {
+#if LLVM_VERSION_MAJOR < 17
+        std::string file = sm.getFileEntryForID(it->first)->getName().str();
+#else
+        std::string file = sm.getFileEntryRefForID(it->first)->getName().str();
+#endif
+        std::string content;
+        llvm::raw_string_ostream os(content);
+        it->second.write(os);
+        os.flush();
+        if (deferred_writes.active_)
+        {
+            deferred_writes.files_[file] = content;
+        }
+        else
+        {
+            FileOverlay::get().write(file, content);
+        }
+    }
+}
+
+void ToolRunner::write_file(const std::string &file, const std::function<void(llvm::raw_ostream &)> &producer)
+{
+    {
+        std::unique_lock<std::mutex> lock(deferred_writes.mtx_);
+        if (!deferred_writes.active_)
+        {
+            lock.unlock();
+            FileOverlay::get().write(file, producer);
+            return;
+        }
+    }
+
+    // produce outside of the lock, TUs of a parallel run write concurrently
+    if (FileOverlay::get().is_enabled())
+    {
+        std::string content;
+        llvm::raw_string_ostream os(content);
+        producer(os);
+        os.flush();
+        std::unique_lock<std::mutex> lock(deferred_writes.mtx_);
+        deferred_writes.files_[file] = std::move(content);
+        return;
+    }
+
+    // stream to the temporary already, so the content is never held in memory as a whole
+    fs::path tmp_path = util::get_replacement_path(file);
+    {
+        std::error_code ec;
+        llvm::raw_fd_ostream os(tmp_path.string(), ec);
+        if (ec)
+        {
+            LOG_FATAL("ToolRunner::write_file(): Could not create file at [", tmp_path.string(), "]: ", ec.message());
+        }
+        producer(os);
+    }
+    std::unique_lock<std::mutex> lock(deferred_writes.mtx_);
+    deferred_writes.streamed_[file] = tmp_path;
+}
+
+void ToolRunner::wait_for_turn(void)
+{
+    if (ticket.seq_ == nullptr || ticket.entered_)
+    {
+        return;
+    }
+    ticket.seq_->wait(ticket.idx_);
+    ticket.entered_ = true;
+}
+
+int ToolRunner::run(const std::vector<std::string> &files, clang::tooling::ToolAction *action, bool isolated) const
+{
+    if (files.empty())
+    {
+        return 0;
+    }
+    IsolationGuard guard(isolated);
+    if (jobs_ <= 1 || files.size() <= 1)
+    {
+        return run_serial(files, action);
+    }
+    return run_parallel(files, action);
+}
+
+int ToolRunner::run(const std::vector<std::string> &files, ASTToolAction *action, bool isolated) const
+{
+    if (cache_ == nullptr)
+    {
+        return run(files, static_cast<clang::tooling::ToolAction *>(action), isolated);
+    }
+
+    IsolationGuard guard(isolated);
+    cache_->begin_round();
+    std::vector<std::string> missing;
+    for (auto const &file : files)
+    {
+        if (cache_->get(file) == nullptr)
+        {
+            missing.push_back(file);
+        }
+    }
+    LOG_VERBOSE("AST cache: reusing ", std::to_string(files.size() - missing.size()), " of ",
+                std::to_string(files.size()), " translation units");
+
+    std::vector<std::unique_ptr<clang::ASTUnit>> asts(missing.size());
+    int ret = build_asts(missing, asts);
+    for (size_t i = 0; i < missing.size(); ++i)
+    {
+        if (asts[i])
+        {
+            cache_->store(missing[i], std::move(asts[i]));
+        }
+    }
+
+    for (auto const &file : files)
+    {
+        if (clang::ASTUnit *unit = cache_->get(file))
+        {
+            action->run_on_ast(*unit);
+        }
+    }
+    return ret;
+}
+
+int ToolRunner::build_asts(const std::vector<std::string> &files,
+                           std::vector<std::unique_ptr<clang::ASTUnit>> &asts) const
+{
+    std::vector<int> results(files.size(), 0);
+    bool own_vfs = (jobs_ > 1 && files.size() > 1);
+
+    auto build = [&](size_t idx) {
+        std::vector<std::unique_ptr<clang::ASTUnit>> unit;
+        // see run_parallel(): concurrent tools must not share the process' working directory
+        llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> vfs = FileOverlay::get().create_vfs(
+            own_vfs ? llvm::vfs::createPhysicalFileSystem() : llvm::vfs::getRealFileSystem());
+        clang::tooling::ClangTool tool(compilations_, { files[idx] }, std::make_shared<clang::PCHContainerOperations>(),
+                                       vfs);
+        if (adjuster_)
+        {
+            adjuster_(tool);
+        }
+        auto start = std::chrono::steady_clock::now();
+        results[idx] = tool.buildASTs(unit);
+        util::timereport::add_file_time(files[idx], util::timereport::seconds_since(start), 0);
+        if (unit.size() == 1)
+        {
+            asts[idx] = std::move(unit.front());
+        }
+        else
+        {
+            results[idx] = 1;
+        }
+    };
+
+    if (own_vfs)
+    {
+        parallel_for(files.size(), std::min<size_t>(jobs_, files.size()), build);
+    }
+    else
+    {
+        for (size_t idx = 0; idx < files.size(); ++idx)
+        {
+            build(idx);
+        }
+    }
+
+    int ret = 0;
+    for (auto r : results)
+    {
+        ret = merge_result(ret, r);
+    }
+    return ret;
+}
+
+int ToolRunner::run_serial(const std::vector<std::string> &files, clang::tooling::ToolAction *action) const
+{
+    clang::tooling::ClangTool tool(compilations_, files, std::make_shared<clang::PCHContainerOperations>(),
+                                   FileOverlay::get().create_vfs(llvm::vfs::getRealFileSystem()));
+    if (adjuster_)
+    {
+        adjuster_(tool);
+    }
+    return tool.run(action);
+}
+
+int ToolRunner::run_parallel(const std::vector<std::string> &files, clang::tooling::ToolAction *action) const
+{
+    unsigned workers = std::min<size_t>(jobs_, files.size());
+    LOG_INFO("Running ", std::to_string(files.size()), " translation units on ", std::to_string(workers),
+             " worker threads");
+
+    Sequencer seq;
+    std::atomic<size_t> next_file{ 0 };
+    std::atomic<bool> abort{ false };
+    std::mutex result_mtx;
+    int ret = 0;
+    std::vector<std::exception_ptr> errors(files.size());
+
+    auto worker = [&]() {
+        while (true)
+        {
+            size_t idx = next_file++;
+            if (idx >= files.size())
+            {
+                break;
+            }
+            ticket = Ticket{ &seq, idx, false };
+            if (!abort)
+            {
+                try
+                {
+                    // Each worker gets its own physical file system view, so concurrent tools do not share (and
+                    // change) the process' working directory.
+                    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> vfs =
+                        FileOverlay::get().create_vfs(llvm::vfs::createPhysicalFileSystem());
+                    clang::tooling::ClangTool tool(compilations_, { files[idx] },
+                                                   std::make_shared<clang::PCHContainerOperations>(), vfs);
+                    if (adjuster_)
+                    {
+                        adjuster_(tool);
+                    }
+                    int r = tool.run(action);
+                    std::unique_lock<std::mutex> lock(result_mtx);
+                    ret = merge_result(ret, r);
+                }
+                catch (...)
+                {
+                    errors[idx] = std::current_exception();
+                    abort = true;
+                }
+            }
+            seq.release(idx);
+            ticket = Ticket{};
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        pool.emplace_back(worker);
+    }
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+
+    // re-throw the first failure in input order, as a serial run would have
+    for (auto const &e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+    return ret;
+}
+
+} // namespace vrtlmod
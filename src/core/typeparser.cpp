@@ -0,0 +1,316 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file typeparser.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/typeparser.hpp"
+#include "vrtlmod/util/logging.hpp"
+#include "vrtlmod/util/utility.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+#include <vector>
+
+namespace vrtlmod
+{
+
+namespace
+{
+constexpr std::string_view DIGITS = "123456789";
+constexpr std::string_view WIDE = "W";
+constexpr char NAME_MASK = '\x01'; ///< replaces the variable name in the cache key of signals
+
+bool starts_with(std::string_view str, std::string_view prefix)
+{
+    return str.substr(0, prefix.size()) == prefix;
+}
+
+bool contains(std::string_view str, std::string_view sub)
+{
+    return str.find(sub) != std::string_view::npos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Returns true if str contains the comment `/*<name>[<repeat>]**/`
+bool has_marker(std::string_view str, std::string_view name, std::string_view repeat)
+{
+    for (auto pos = str.find(name); pos != std::string_view::npos; pos = str.find(name, pos + 1))
+    {
+        if (pos < 2 || str.substr(pos - 2, 2) != "/*")
+        {
+            continue;
+        }
+        auto end = str.find_first_not_of(repeat, pos + name.size());
+        if (end != std::string_view::npos && str.substr(end, 2) == "*/")
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool is_ctype_port(std::string_view decl)
+{
+    return has_marker(decl, "VL_IN", DIGITS) || has_marker(decl, "VL_OUT", DIGITS) ||
+           has_marker(decl, "VL_INOUT", DIGITS);
+}
+
+bool is_wctype_port(std::string_view decl)
+{
+    return has_marker(decl, "VL_IN", WIDE) || has_marker(decl, "VL_OUT", WIDE) || has_marker(decl, "VL_INOUT", WIDE);
+}
+
+bool is_sctype_port(std::string_view decl)
+{
+    return contains(decl, "sc_in<") || contains(decl, "sc_out<");
+}
+
+std::string strip(std::string_view str)
+{
+    std::string ret(str);
+    ret.erase(std::remove_if(ret.begin(), ret.end(), [](unsigned char x) { return std::isspace(x); }), ret.end());
+    return ret;
+}
+} // namespace
+
+VlTypeInfo VlTypeParser::parse_uncached(std::string_view id, std::string_view type, std::string_view decl)
+{
+    VlTypeInfo ret;
+    std::string_view msb = "msb";
+    std::string_view lsb = "lsb";
+    std::string port_base; // storage of views that are not taken from decl
+    std::string sc_msb;
+    std::vector<std::pair<std::string_view, std::string_view>> unpacked;
+
+    if (is_ctype_port(decl))
+    {
+        auto first_col = decl.rfind(id) + id.length() + 1;
+        auto second_col = decl.find(",", first_col + 1);
+        msb = decl.substr(first_col, second_col - first_col);
+        auto last_brace = decl.rfind(")*/;");
+        ++second_col;
+
+        lsb = decl.substr(second_col, last_brace - second_col);
+        ret.var_type_ = has_marker(decl, "VL_IN", DIGITS) ? "in" : "out";
+        unpacked.emplace_back(decl.substr(0, decl.find(id) - 1), "0");
+        LOG_VERBOSE(">>>: is a ctype ", ret.var_type_, " from ", std::string(msb), " to ", std::string(lsb));
+    }
+    else if (is_wctype_port(decl))
+    {
+        auto first_col = decl.rfind(id) + id.length() + 1;
+        auto second_col = decl.find(",", first_col + 1);
+        auto third_col = decl.find(",", second_col + 1);
+        msb = decl.substr(first_col, second_col - first_col);
+        ++second_col;
+        lsb = decl.substr(second_col, third_col - second_col);
+        ret.var_type_ = has_marker(decl, "VL_IN", WIDE) ? "in" : "out";
+#if VRTLMOD_VERILATOR_VERSION <= 4204
+        // base type and word array, e.g., `WData name[4]` without the name
+        auto openbrace = decl.find('[');
+        auto closebrace = decl.find(']');
+        port_base = util::concat(std::string(decl.substr(0, decl.find(id) - 1)),
+                                 std::string(decl.substr(openbrace, closebrace - openbrace + 1)));
+        unpacked.emplace_back(port_base, "0");
+#else // VRTLMOD_VERILATOR_VERSION <= 4228
+        unpacked.emplace_back(decl.substr(0, decl.find(id) - 1), "0");
+#endif
+        LOG_VERBOSE(">>>: is a wctype ", ret.var_type_, " from ", std::string(msb), " to ", std::string(lsb));
+    }
+    else if (is_sctype_port(decl))
+    {
+        ret.var_type_ = contains(decl, "sc_in<") ? "in" : "out";
+
+        auto open_templ = decl.find("<");
+        auto close_templ = decl.rfind(">");
+        auto outer_str = decl.substr(0, open_templ);
+        auto inner_str = decl.substr(open_templ + 1, close_templ - (open_templ + 1));
+
+        if (starts_with(inner_str, "sc_bv<"))
+        {
+            auto open_templ = inner_str.find("<");
+            auto close_templ = inner_str.rfind(">");
+            std::string width(inner_str.substr(open_templ + 1, close_templ - (open_templ + 1)));
+            sc_msb = std::to_string(std::stoi(width) - 1);
+            msb = sc_msb;
+            lsb = "0";
+        }
+        else if (contains(inner_str, "int64_"))
+        {
+            msb = "63";
+            lsb = "0";
+        }
+        else if (contains(inner_str, "int32_"))
+        {
+            msb = "31";
+            lsb = "0";
+        }
+        else if (contains(inner_str, "int16_"))
+        {
+            msb = "15";
+            lsb = "0";
+        }
+        else if (contains(inner_str, "int8_"))
+        {
+            msb = "7";
+            lsb = "0";
+        }
+        else if (starts_with(inner_str, "bool") || starts_with(inner_str, "Bool"))
+        {
+            msb = "0";
+            lsb = "0";
+        }
+        else
+        {
+            msb = "undef";
+            lsb = "undef";
+        }
+
+        unpacked.emplace_back(decl.substr(0, decl.find(id)), "0");
+        LOG_VERBOSE(">>>: is a sctype port ", std::string(outer_str), " - ", std::string(inner_str), "!!!");
+
+        // TODO: Support bitfield extraction for systemc type ports (only top level is systemc, but only
+        // sc_{in,out}<stdint> is supported)
+    }
+    else // something else aka must be a signal
+    {
+        if (starts_with(type, "VlUnpacked<"))
+        {
+            // peel VlUnpacked<inner, dim> layers until the innermost (zero dimensional) type
+            std::string_view search = decl;
+            bool still_going = false;
+            do
+            {
+                auto open_templ = search.find("<");
+                auto close_templ = search.rfind(">");
+                auto comma = search.rfind(",");
+                auto outer_dim = search.substr(comma + 1, close_templ - (comma + 1));
+                unpacked.emplace_back(search.substr(0, open_templ), outer_dim);
+                search = search.substr(open_templ + 1, comma - (open_templ + 1));
+                still_going = starts_with(search, "VlUnpacked<");
+                if (!still_going)
+                {
+                    unpacked.emplace_back(search, outer_dim);
+                }
+            } while (still_going);
+        }
+        else // packed signal
+        {
+            unpacked.emplace_back(decl.substr(0, decl.find(" ")), "0");
+        }
+
+        std::string_view zerodim_typestr = unpacked.back().first;
+        auto open_comm = zerodim_typestr.find("/*");
+        auto colon_comm = zerodim_typestr.find(":");
+        auto close_comm = zerodim_typestr.rfind("*/");
+        msb = zerodim_typestr.substr(open_comm + 2, colon_comm - (open_comm + 2));
+        lsb = zerodim_typestr.substr(colon_comm + 1, close_comm - (colon_comm + 1));
+        ret.var_type_ = "var";
+    }
+
+    std::string zerodim_dim = util::concat(std::string(msb), ":", std::string(lsb));
+    unpacked.back().second = zerodim_dim;
+    unpacked.back().first = unpacked.back().first.substr(0, unpacked.back().first.find("/*"));
+
+    int msb_bits = 0;
+    int lsb_bits = 0;
+    bool valid_range = true;
+    try
+    {
+        msb_bits = boost::lexical_cast<int>(msb);
+        lsb_bits = boost::lexical_cast<int>(lsb);
+    }
+    catch (boost::bad_lexical_cast)
+    {
+        valid_range = false;
+    }
+
+    std::string bases, dim;
+    bool first_base = true;
+    for (auto const &pair_ : unpacked)
+    {
+        // now we can clean whitespaces
+        std::string base = strip(pair_.first);
+        std::string base_dim = strip(pair_.second);
+
+        if (first_base)
+        {
+            first_base = false;
+            bases = base;
+            dim = base_dim;
+        }
+        else
+        {
+            bases = util::concat(bases, ", ", base);
+            dim = util::concat(dim, ", ", base_dim);
+        }
+
+        try
+        {
+            if (base_dim.find(":") == std::string::npos)
+            {
+                ret.bits_ *= boost::lexical_cast<int>(base_dim);
+            }
+            else
+            {
+                ret.bits_ *= valid_range ? ((msb_bits + 1) - lsb_bits) : 0;
+            }
+        }
+        catch (boost::bad_lexical_cast)
+        {
+            ret.bits_ *= 0; // force total bit length to zero to trigger invalidation.
+        }
+    }
+    ret.bases_ = bases;
+    ret.dim_ = dim;
+    return ret;
+}
+
+const VlTypeInfo &VlTypeParser::parse(const std::string &id, const std::string &type, const std::string &decl)
+{
+    std::string key;
+    std::string parsed = decl;
+    if (is_ctype_port(decl) || is_wctype_port(decl) || is_sctype_port(decl))
+    {
+        key = util::concat("port\n", id, "\n", type, "\n", decl); // ports are located by their name
+    }
+    else
+    {
+        // signals are parsed in their masked form, so that the result only depends on the key
+        auto pos = parsed.rfind(id);
+        if (pos != std::string::npos)
+        {
+            parsed.replace(pos, id.length(), 1, NAME_MASK);
+        }
+        key = util::concat("signal\n", type, "\n", parsed);
+    }
+
+    auto it = cache_.find(key);
+    if (it != cache_.end())
+    {
+        ++hits_;
+        return it->second;
+    }
+    ++misses_;
+
+    return cache_.emplace(key, parse_uncached(id, type, parsed)).first->second;
+}
+
+} // namespace vrtlmod
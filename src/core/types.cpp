@@ -99,77 +99,56 @@ bool Target::check_assigned_here(const clang::MemberExpr *assignee, const clang:
     return ret;
 }
 
-std::vector<std::string> Target::get_cxx_dimension_types(void) const
+const Target::Attributes &Target::get_attributes(void) const
 {
-    return get_cxx_dimensions().first;
-}
-
-std::vector<int> Target::get_cxx_dimension_lengths(void) const
-{
-    return get_cxx_dimensions().second;
-}
-
-inline std::pair<int, int> Target::get_element_msb_lsb_pair(void) const
-{
-    int msb = -1, lsb = -1;
-    std::string s, dimstr = get_dimensions();
-    auto brOpen = dimstr.find('[');
-    auto brClose = dimstr.rfind(']');
-    dimstr = dimstr.substr(brOpen + 1, brClose - brOpen - 1);
-    dimstr.erase(remove_if(dimstr.begin(), dimstr.end(), isspace), dimstr.end());
-    std::istringstream x(dimstr);
-    while (getline(x, s, ','))
+    if (!attributes_)
     {
-        s = s.substr(s.find("'") + 1, s.rfind("'") - s.find("'") - 1);
-        if (s.find(':') != std::string::npos)
-        {
-            std::string up = s.substr(0, s.find(':'));
-            std::string to = s.substr(s.find(':') + 1);
-            msb = boost::lexical_cast<int>(up);
-            lsb = boost::lexical_cast<int>(to);
-            break;
-        }
+        attributes_ = parse_attributes();
     }
-    return { msb, lsb };
+    return *attributes_;
 }
 
-inline std::vector<int> Target::get_dimension_lengths(void) const
+std::unique_ptr<const Target::Attributes> Target::parse_attributes(void) const
 {
-    std::vector<int> dim{};
+    auto ret = std::make_unique<Attributes>();
+    ret->bits_ = Variable::get_bits();
+
+    // dimensions, e.g., [4, 7:0]
     std::string s, dimstr = get_dimensions();
     auto brOpen = dimstr.find('[');
     auto brClose = dimstr.rfind(']');
     dimstr = dimstr.substr(brOpen + 1, brClose - brOpen - 1);
     dimstr.erase(remove_if(dimstr.begin(), dimstr.end(), isspace), dimstr.end());
     std::istringstream x(dimstr);
+    bool found_range = false;
     while (getline(x, s, ','))
     {
         s = s.substr(s.find("'") + 1, s.rfind("'") - s.find("'") - 1);
         if (s.find(':') == std::string::npos)
-            dim.push_back(boost::lexical_cast<int>(s));
+            ret->dimension_lengths_.push_back(boost::lexical_cast<int>(s));
         else
         {
             std::string up = s.substr(0, s.find(':'));
             std::string to = s.substr(s.find(':') + 1);
             int iup = boost::lexical_cast<int>(up);
             int ito = boost::lexical_cast<int>(to);
-            dim.push_back(iup - ito + 1);
+            ret->dimension_lengths_.push_back(iup - ito + 1);
+            if (!found_range)
+            {
+                found_range = true;
+                ret->element_msb_lsb_ = { iup, ito };
+            }
         }
     }
-    return dim;
-}
-
-inline std::pair<std::vector<std::string>, std::vector<int>> Target::get_cxx_dimensions(void) const
-{
-    std::pair<std::vector<std::string>, std::vector<int>> dim{};
-    auto &cxxtypedim = dim.first;
-    auto &cxxdim = dim.second;
-    cxxdim = get_dimension_lengths();
 
-    std::string s, basetypestr = get_bases();
+    // base types, e.g., [VlUnpacked<CData, 4>, CData]
+    auto &cxxtypedim = ret->cxx_dimension_types_;
+    auto &cxxdim = ret->cxx_dimension_lengths_;
+    cxxdim = ret->dimension_lengths_;
 
-    auto brOpen = basetypestr.find('[');
-    auto brClose = basetypestr.rfind(']');
+    std::string basetypestr = get_bases();
+    brOpen = basetypestr.find('[');
+    brClose = basetypestr.rfind(']');
     basetypestr = basetypestr.substr(brOpen + 1, brClose - brOpen - 1);
     basetypestr.erase(remove_if(basetypestr.begin(), basetypestr.end(), isspace), basetypestr.end());
     std::istringstream basetypestream(basetypestr);
@@ -179,6 +158,10 @@ inline std::pair<std::vector<std::string>, std::vector<int>> Target::get_cxx_dim
         cxxtypedim.push_back(s);
     }
 
+    if (cxxtypedim.empty() || cxxdim.empty())
+    {
+        return ret;
+    }
     if (cxxtypedim.back().find("VlWide<") != std::string::npos)
     {
         auto dimstr = cxxtypedim.back();
@@ -202,13 +185,30 @@ inline std::pair<std::vector<std::string>, std::vector<int>> Target::get_cxx_dim
         cxxdim.pop_back();
     }
 
-    return dim;
+    // element masks, see get_element_mask()
+    for (int i = std::max(ret->element_msb_lsb_.second, 0);
+         i < std::min<int>(ret->element_msb_lsb_.first + 1, sizeof(unsigned long) * 8); ++i)
+    {
+        ret->element_mask_ |= 1UL << i;
+    }
+    auto active_bits = ret->dimension_lengths_.back() % (sizeof(WData) * 8);
+    if (active_bits == 0) // fully used last word, i.e., no inactive rest
+    {
+        ret->last_word_mask_ = WData(-1);
+    }
+    else
+    {
+        for (unsigned i = 0; i < active_bits; ++i)
+        {
+            ret->last_word_mask_ |= 1UL << i;
+        }
+    }
+    return ret;
 }
 
 unsigned long Target::get_element_mask(std::initializer_list<size_t> subscripts) const
 {
-    unsigned long mask = 0;
-    auto dimlens = get_cxx_dimension_lengths();
+    auto &dimlens = get_cxx_dimension_lengths();
 
     if (subscripts.size() != dimlens.size())
     {
@@ -223,38 +223,15 @@ unsigned long Target::get_element_mask(std::initializer_list<size_t> subscripts)
         return -1;
     }
 
-    auto one_dim_bits = get_one_dim_bits();
-    auto msblsb_pair = get_element_msb_lsb_pair();
-    auto msb = msblsb_pair.first;
-    auto lsb = msblsb_pair.second;
-
-    if (one_dim_bits >
-        sizeof(QData) * 8) //(cxxtypedim.back().find("WData[") != std::string::npos) //(one_dim_bits > 64)
-    {
-        int elementsubs = *(subscripts.end() - 1);
-        int elementsize = dimlens.back();
-        auto active_bits = one_dim_bits % (sizeof(WData) * 8);
-        // packed in WData
-        if (((elementsubs + 1) != elementsize) || (active_bits == 0) // fully used last element, i.e., no inactive rest
-        )
-        {
-            mask = WData(-1);
-        }
-        else
-        {
-            for (int i = 0; i < active_bits; ++i)
-            {
-                mask |= 1 << i;
-            }
-        }
-    }
-    else
+    if (get_one_dim_bits() > int(sizeof(QData) * 8))
     {
-        // unpacked
-        for (int i = lsb; i < msb + 1; ++i)
-            mask |= 1 << i;
+        // packed in WData, only the last word may have inactive bits
+        size_t elementsubs = *(subscripts.end() - 1);
+        size_t elementsize = dimlens.back();
+        return ((elementsubs + 1) != elementsize) ? WData(-1) : get_attributes().last_word_mask_;
     }
-    return mask;
+    // unpacked
+    return get_attributes().element_mask_;
 }
 
 } // namespace types
@@ -23,10 +23,12 @@
 #include "vrtlmod/passes/pass.hpp"
 
 #include "vrtlmod/util/logging.hpp"
+#include "vrtlmod/util/timereport.hpp"
 
 #include <sstream>
 #include <string>
 #include <algorithm>
+#include <map>
 
 using namespace clang;
 using namespace clang::ast_matchers;
@@ -48,6 +50,7 @@ void VrtlParser::run(const clang::ast_matchers::MatchFinder::MatchResult &Result
         LOG_VERBOSE("{comp}: ", get_source_code_str(x));
     }
 
+    ++matches_;
     for (const auto &pass : passes_)
     {
         pass->action(*this, Result);
@@ -139,8 +142,7 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
             .bind(
                 "signal_decl"); ///< field declarations of verilated signals (non reference) = instances of data storage
 
-    const auto compound_of_sequent_func =
-        compoundStmt(hasParent(functionDecl(
+    const auto sequent_func = functionDecl(
 #if VRTLMOD_VERILATOR_VERSION <= 4204
             anyOf(
                 matchesName("::_sequent__*"),
@@ -152,7 +154,10 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
                 matchesName("__multiclk__*")
             )
 #endif
-        ).bind("sequent_function_def")))
+        ); ///< sequential evaluation functions
+
+    const auto compound_of_sequent_func =
+        compoundStmt(hasParent(sequent_func.bind("sequent_function_def")))
             .bind("compound_of_sequent_func"); ///< compound statements (`{...}`) of sequential evaluation functions
 
     const auto symtbl_instance_signal_expr = // {symboltable}->{instance}.{signal}
@@ -215,72 +220,7 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
             hasObjectExpression(this_signal_expr))
             .bind("wsignal_field");
 
-    const auto seq_assignment_matcher = binaryOperator(
-        isAssignmentOperator(),
-        hasLHS(anyOf(
-            top_wsignal_expr,
-            top_signal_expr,
-            symtbl_instance_wsignal_expr,
-            symtbl_instance_signal_expr,
-            this_wsignal_expr,
-            this_signal_expr,
-            cxxOperatorCallExpr(
-                hasOverloadedOperatorName("[]"),
-                hasArgument(
-                    0, anyOf(
-                        //>>>
-                        hasDescendant(top_wsignal_expr),
-                        hasDescendant(top_signal_expr),
-                        hasDescendant(symtbl_instance_wsignal_expr),
-                        hasDescendant(symtbl_instance_signal_expr),
-                        hasDescendant(this_wsignal_expr),
-                        hasDescendant(this_signal_expr) //<<< this block of expr solves multi-dimensional x[][][]
-                        ,
-
-                        //>>>
-                        top_wsignal_expr,
-                        top_signal_expr,
-                        symtbl_instance_wsignal_expr,
-                        symtbl_instance_signal_expr,
-                        this_wsignal_expr,
-                        this_signal_expr //<<< this block of expr solves onedimensional x[]
-                        )
-                    )
-                )
-                .bind("oop")
-
-            ,
-            arraySubscriptExpr(
-                hasBase(
-                anyOf(
-                    //>>> this is odd it gives the {signal} match to the subscript not the base
-                    hasDescendant(top_wsignal_expr),
-                    hasDescendant(top_signal_expr),
-                    hasDescendant(symtbl_instance_wsignal_expr),
-                    hasDescendant(symtbl_instance_signal_expr),
-                    hasDescendant(this_wsignal_expr),
-                    hasDescendant(this_signal_expr) //<<< this block of expr solves multi-dimensional x[][][]
-                    ,
-                    //>>>
-                    top_wsignal_expr,
-                    top_signal_expr,
-                    symtbl_instance_wsignal_expr,
-                    symtbl_instance_signal_expr,
-                    this_wsignal_expr,
-                    this_signal_expr //<<< this block of expr solves onedimensional x[]
-                ))
-                )
-                .bind("array")
-
-            )
-        )
-        //,hasAncestor(functionDecl(hasBody(compoundStmt()), matchesName("::_sequent_*")))
-        // we do not match like this easily because Ancestor and Parent only matches direct upward-relatives
-        // check with is_in_sequent() lambda in traversal
-    ); ///< trivial sequential assignment (`a=...`, `a[..]=...`, etc.)
-
     const auto sea_binary_trivial = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             anyOf(
                 top_wsignal_expr,
@@ -294,7 +234,6 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     );
 
     const auto sea_binary_array_1d = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             arraySubscriptExpr(
                 hasBase(
@@ -335,7 +274,6 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     );
 
     const auto sea_binary_array_2d = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             arraySubscriptExpr(
                 hasBase(
@@ -375,7 +313,6 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     );
 
     const auto sea_binary_array_oop_oop_3d = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             arraySubscriptExpr(
                 hasBase(
@@ -418,7 +355,6 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     );
 
     const auto sea_binary_array_oop_2d = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             arraySubscriptExpr(
                 hasBase(
@@ -455,7 +391,6 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     );
 
     const auto sea_binary_array_3d = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             arraySubscriptExpr(
                 hasBase(
@@ -503,7 +438,6 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     );
 
     const auto sea_binary_oop_1d = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             cxxOperatorCallExpr(
                 hasOverloadedOperatorName("[]"),
@@ -524,7 +458,6 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     );
 
     const auto sea_binary_oop_2d = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             cxxOperatorCallExpr(
                 hasOverloadedOperatorName("[]"),
@@ -551,7 +484,6 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     );
 
     const auto sea_binary_oop_3d = binaryOperator(
-        isAssignmentOperator(),
         hasLHS(
             cxxOperatorCallExpr(
                 hasOverloadedOperatorName("[]"),
@@ -583,7 +515,10 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
         )
     );
 
-    finder.addMatcher(compoundStmt().bind("compound"), this);
+    // Assignments only matter within sequential evaluation functions. The compound and the merged assignment matchers
+    // are evaluated against every node of the translation unit, so they reject everything else before looking at the
+    // operands.
+    finder.addMatcher(compoundStmt(forFunction(sequent_func)).bind("compound"), this);
 
     finder.addMatcher(topref_decl, this);
     finder.addMatcher(instance_decl, this);
@@ -592,130 +527,164 @@ void VrtlParser::addMatcher(clang::ast_matchers::MatchFinder &finder)
     finder.addMatcher(compound_of_sequent_func, this);
     finder.addMatcher(functionDecl().bind("function"), this);
 
-    // matches any non complex member assignment.
-    finder.addMatcher(sea_binary_trivial.bind("sea_binary_trivial"), this);
-
-    // matches: VlWide<>
-    finder.addMatcher(sea_binary_array_1d.bind("sea_binary_array_1d"), this);
-    // matches: WData[][] (should not be the used after VERILATOR version>4.202)
-    finder.addMatcher(sea_binary_array_2d.bind("sea_binary_array_2d"), this);
-    // matches: WData[][][] (should not be the used after VERILATOR version>4.202)
-    finder.addMatcher(sea_binary_array_2d.bind("sea_binary_array_3d"), this);
-
-    // matches: VlUnpacked<>
-    finder.addMatcher(sea_binary_oop_1d.bind("sea_binary_oop_1d"), this);
-    // matches: VlUnpacked<VlUnpacked<>>
-    finder.addMatcher(sea_binary_oop_2d.bind("sea_binary_oop_2d"), this);
-    // matches: VlUnpacked<VlUnpacked<VlUnpacked<>>>
-    finder.addMatcher(sea_binary_oop_3d.bind("sea_binary_oop_3d"), this);
-
-    // matches: VlUnpacked<VlWide<>>
-    finder.addMatcher(sea_binary_array_oop_2d.bind("sea_binary_array_oop_2d"), this);
-    // matches: VlUnpacked<VlUnpacked<VlWide<>>>
-    finder.addMatcher(sea_binary_array_oop_oop_3d.bind("sea_binary_array_oop_oop_3d"), this);
+    // One matcher for all sequential binary assignments. The shapes of the LHS exclude each other, anyOf() stops at
+    // the first matching one and binds the assignment under its name, the passes dispatch on it.
+    finder.addMatcher(
+        binaryOperator(
+            isAssignmentOperator(),
+            forFunction(sequent_func),
+            anyOf(
+                // matches: VlUnpacked<VlUnpacked<VlWide<>>>
+                sea_binary_array_oop_oop_3d.bind("sea_binary_array_oop_oop_3d"),
+                // matches: VlUnpacked<VlUnpacked<VlUnpacked<>>>
+                sea_binary_oop_3d.bind("sea_binary_oop_3d"),
+                // matches: WData[][][] (should not be the used after VERILATOR version>4.202). Before the merge, the 2D
+                // matcher was registered under this name instead, so 3D assignments were never matched and 2D ones
+                // aborted the rewrite
+                sea_binary_array_3d.bind("sea_binary_array_3d"),
+                // matches: VlUnpacked<VlWide<>>
+                sea_binary_array_oop_2d.bind("sea_binary_array_oop_2d"),
+                // matches: VlUnpacked<VlUnpacked<>>
+                sea_binary_oop_2d.bind("sea_binary_oop_2d"),
+                // matches: WData[][] (should not be the used after VERILATOR version>4.202)
+                sea_binary_array_2d.bind("sea_binary_array_2d"),
+                // matches: VlUnpacked<>
+                sea_binary_oop_1d.bind("sea_binary_oop_1d"),
+                // matches: VlWide<>
+                sea_binary_array_1d.bind("sea_binary_array_1d"),
+                // matches any non complex member assignment.
+                sea_binary_trivial.bind("sea_binary_trivial")
+            )
+        ),
+        this);
 
-    for (const auto &it : func_macros_regex_paraidx_)
-    {
-        const auto seq_assignment_func_matcher = callExpr(
-            allOf(
-                callee(
-                    functionDecl(
-                        matchesName(it.first)
-                    )
-                ),
-                hasArgument(
-                    it.second,
-                    anyOf(
-                        cxxMemberCallExpr(
-                            anyOf(
-                                callee(top_wsignal_expr),
-                                callee(top_signal_expr),
-                                callee(symtbl_instance_wsignal_expr),
-                                callee(symtbl_instance_signal_expr),
-                                callee(this_signal_expr),
-                                callee(this_wsignal_expr)
-                            ) // callees
-                        ).bind("arg1_expr"),
-                        expr(top_wsignal_expr).bind("arg1_expr"),
-                        expr(top_signal_expr).bind("arg1_expr"),
-                        expr(symtbl_instance_wsignal_expr).bind("arg1_expr"),
-                        expr(symtbl_instance_signal_expr).bind("arg1_expr"),
-                        expr(this_signal_expr).bind("arg1_expr"),
-                        expr(this_wsignal_expr).bind("arg1_expr")
-                        ,
-                        cxxMemberCallExpr(
-                            has(
-                                memberExpr(
-                                    has(
-                                        cxxOperatorCallExpr(
-                                            hasOverloadedOperatorName("[]"),
-                                            hasArgument(
-                                                0,
-                                                anyOf(
-                                                    //>>>
-                                                    top_wsignal_expr,
-                                                    top_signal_expr,
-                                                    symtbl_instance_wsignal_expr,
-                                                    symtbl_instance_signal_expr,
-                                                    this_wsignal_expr,
-                                                    this_signal_expr //<<< this block of expr solves onedimensional x[]
-                                                )
-                                            )
-                                        ).bind("oop_1d")
+    const auto sea_func_arg =
+        anyOf(
+            cxxMemberCallExpr(
+                anyOf(
+                    callee(top_wsignal_expr),
+                    callee(top_signal_expr),
+                    callee(symtbl_instance_wsignal_expr),
+                    callee(symtbl_instance_signal_expr),
+                    callee(this_signal_expr),
+                    callee(this_wsignal_expr)
+                ) // callees
+            ).bind("arg1_expr"),
+            expr(top_wsignal_expr).bind("arg1_expr"),
+            expr(top_signal_expr).bind("arg1_expr"),
+            expr(symtbl_instance_wsignal_expr).bind("arg1_expr"),
+            expr(symtbl_instance_signal_expr).bind("arg1_expr"),
+            expr(this_signal_expr).bind("arg1_expr"),
+            expr(this_wsignal_expr).bind("arg1_expr")
+            ,
+            cxxMemberCallExpr(
+                has(
+                    memberExpr(
+                        has(
+                            cxxOperatorCallExpr(
+                                hasOverloadedOperatorName("[]"),
+                                hasArgument(
+                                    0,
+                                    anyOf(
+                                        //>>>
+                                        top_wsignal_expr,
+                                        top_signal_expr,
+                                        symtbl_instance_wsignal_expr,
+                                        symtbl_instance_signal_expr,
+                                        this_wsignal_expr,
+                                        this_signal_expr //<<< this block of expr solves onedimensional x[]
                                     )
                                 )
-                            )
-                        ).bind("arg1_expr")
-                        ,
-                        cxxMemberCallExpr(
-                            has(
-                                memberExpr(
-                                    has(
-                                        cxxOperatorCallExpr(
-                                            hasOverloadedOperatorName("[]"),
-                                            hasArgument(
-                                                0,
-                                                cxxOperatorCallExpr(
-                                                    hasOverloadedOperatorName("[]"),
-                                                    hasArgument(
-                                                        0,
-                                                        anyOf(
-                                                            //>>>
-                                                            top_wsignal_expr,
-                                                            top_signal_expr,
-                                                            symtbl_instance_wsignal_expr,
-                                                            symtbl_instance_signal_expr,
-                                                            this_wsignal_expr,
-                                                            this_signal_expr //<<< this block of expr solves onedimensional x[]
-                                                        )
-                                                    )
-                                                ).bind("oop_1d")
+                            ).bind("oop_1d")
+                        )
+                    )
+                )
+            ).bind("arg1_expr")
+            ,
+            cxxMemberCallExpr(
+                has(
+                    memberExpr(
+                        has(
+                            cxxOperatorCallExpr(
+                                hasOverloadedOperatorName("[]"),
+                                hasArgument(
+                                    0,
+                                    cxxOperatorCallExpr(
+                                        hasOverloadedOperatorName("[]"),
+                                        hasArgument(
+                                            0,
+                                            anyOf(
+                                                //>>>
+                                                top_wsignal_expr,
+                                                top_signal_expr,
+                                                symtbl_instance_wsignal_expr,
+                                                symtbl_instance_signal_expr,
+                                                this_wsignal_expr,
+                                                this_signal_expr //<<< this block of expr solves onedimensional x[]
                                             )
-                                        ).bind("oop_2d")
-                                    )
+                                        )
+                                    ).bind("oop_1d")
                                 )
-                            )
-                        ).bind("arg1_expr")
+                            ).bind("oop_2d")
+                        )
                     )
                 )
-            )
-        );
-        finder.addMatcher(seq_assignment_func_matcher.bind("sea_func"), this);
+            ).bind("arg1_expr")
+        ); ///< signal argument of a Verilator functional macro
+
+    // One matcher for all Verilator functional macros, one regex per index of the assigned argument
+    std::map<unsigned, std::string> func_regex_by_paraidx{ { 1, "" }, { 2, "" }, { 3, "" }, { 4, "" } };
+    for (const auto &it : func_macros_regex_paraidx_)
+    {
+        auto regex = func_regex_by_paraidx.find(it.second);
+        if (regex == func_regex_by_paraidx.end())
+        {
+            LOG_FATAL("Unsupported argument index ", std::to_string(it.second), " of functional macro ", it.first);
+        }
+        regex->second += (regex->second.empty() ? "" : "|") + it.first;
     }
+    const auto sea_func_with_paraidx = [&](unsigned idx)
+    {
+        const std::string &regex = func_regex_by_paraidx.at(idx);
+        return callExpr(
+            callee(
+                functionDecl(
+                    matchesName(regex.empty() ? "^$" : regex) // "^$": qualified names are never empty
+                )
+            ),
+            hasArgument(idx, sea_func_arg)
+        );
+    };
+    finder.addMatcher(
+        callExpr(
+            forFunction(sequent_func),
+            anyOf(
+                sea_func_with_paraidx(1),
+                sea_func_with_paraidx(2),
+                sea_func_with_paraidx(3),
+                sea_func_with_paraidx(4)
+            )
+        ).bind("sea_func"),
+        this);
     // clang-format on
 }
 
 void VrtlParser::onEndOfTranslationUnit(void)
 {
+    // every match is handed to all passes, so a parser reports them once, named by its (fused) passes
+    std::string passes;
     for (const auto &pass : passes_)
     {
         pass->end_of_translation(*this);
+        passes += (passes.empty() ? "" : "+") + std::string(pass->get_name());
     }
+    util::timereport::add_matches(passes, matches_);
+    matches_ = 0;
 }
 
 void VrtlParser::add_pass(std::unique_ptr<VrtlmodPass> pass)
 {
-    passes_.insert(std::move(pass));
+    passes_.push_back(std::move(pass));
 }
 
 VrtlParser::VrtlParser(Consumer &cons) : Handler(cons) {}
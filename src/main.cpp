@@ -20,6 +20,8 @@
 /// @date Created on Mon Jan 15 12:29:21 2020
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <map>
 #include <string>
 #include <sstream>
 #include <fstream>
@@ -32,9 +34,15 @@
 
 #include "vrtlmod/vrtlmod.hpp"
 #include "vrtlmod/core/core.hpp"
+#include "vrtlmod/core/vrtlparse.hpp"
+#include "vrtlmod/core/toolrunner.hpp"
+#include "vrtlmod/core/astcache.hpp"
+#include "vrtlmod/core/incrementalcache.hpp"
+#include "vrtlmod/core/fileoverlay.hpp"
 
 #include "vrtlmod/util/utility.hpp"
 #include "vrtlmod/util/logging.hpp"
+#include "vrtlmod/util/timereport.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 /// \brief Frontend user option category
@@ -49,6 +57,13 @@ static llvm::cl::opt<std::string> WhiteListXmlFilename("wl-regxml", llvm::cl::Op
                                                        llvm::cl::desc("Specify input whitelist register xml"),
                                                        llvm::cl::value_desc("file name"), llvm::cl::cat(UserCat));
 ////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "wl-pattern". Restricts injection targets by patterns
+static llvm::cl::list<std::string> WhiteListPatterns(
+    "wl-pattern", llvm::cl::ZeroOrMore,
+    llvm::cl::desc("Only inject into targets whose <module>::<signal> matches this glob pattern (regex if prefixed "
+                   "with re:). Can be given multiple times, also combines with --wl-regxml"),
+    llvm::cl::value_desc("pattern"), llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
 /// \brief Frontend user option "out". Sets output directory path
 static llvm::cl::opt<std::string> OutputDir("out", llvm::cl::Optional, llvm::cl::desc("Specify output directory"),
                                             llvm::cl::value_desc("path"), llvm::cl::init("vrtlmod-out"),
@@ -88,6 +103,90 @@ static llvm::cl::opt<bool> Verbose("verbose", llvm::cl::Optional, llvm::cl::desc
                                    llvm::cl::cat(UserCat));
 static llvm::cl::alias VerboseA("v", llvm::cl::NotHidden, llvm::cl::desc("Alias for --verbose"),
                                 llvm::cl::aliasopt(Verbose));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "log-file". Redirects the log output
+static llvm::cl::opt<std::string> LogFile("log-file", llvm::cl::Optional,
+                                          llvm::cl::desc("Write the log to a file instead of the console (errors are "
+                                                         "also printed to the console)"),
+                                          llvm::cl::value_desc("file name"), llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "jobs". Number of worker threads for the per-file Clang stages
+static llvm::cl::opt<unsigned> Jobs("jobs", llvm::cl::Optional,
+                                    llvm::cl::desc("Run the per-file Clang stages on N worker threads (0: one per "
+                                                   "hardware thread). Results are identical to a serial run"),
+                                    llvm::cl::value_desc("N"), llvm::cl::init(1), llvm::cl::cat(UserCat));
+static llvm::cl::alias JobsA("j", llvm::cl::NotHidden, llvm::cl::desc("Alias for --jobs"), llvm::cl::aliasopt(Jobs));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "cache-ast". Reuse parsed translation units across stages
+static llvm::cl::opt<bool> CacheAst(
+    "cache-ast", llvm::cl::Optional,
+    llvm::cl::desc("Keep parsed files in memory and reuse them in later stages until a file they include changes"),
+    llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "incremental". Reuse per-file results of previous runs
+static llvm::cl::opt<bool> Incremental(
+    "incremental", llvm::cl::Optional,
+    llvm::cl::desc("Cache per-file results in the output directory and skip the rewrite stages for files that are "
+                   "unchanged since the previous run"),
+    llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "save-snapshot". Keep the analyzed sources for --reinstrument
+static llvm::cl::opt<bool> SaveSnapshot(
+    "save-snapshot", llvm::cl::Optional,
+    llvm::cl::desc("Save the analyzed sources in the output directory, so later runs can --reinstrument them (implied "
+                   "by --incremental)"),
+    llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "reinstrument". Reuse the analysis of a previous run
+static llvm::cl::opt<std::string> Reinstrument(
+    "reinstrument", llvm::cl::Optional,
+    llvm::cl::desc("Skip preprocessing, elaboration and analysis. Load them from the VRTL analysis XML of a previous "
+                   "run with --save-snapshot and the same output directory, e.g., to apply a new whitelist"),
+    llvm::cl::value_desc("file name"), llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "fused-analysis". Elaborate and analyze in a single parse of the VRTL
+static llvm::cl::opt<bool> FusedAnalysis(
+    "fused-analysis", llvm::cl::Optional,
+    llvm::cl::desc("Elaborate and analyze the VRTL in a single parse of each file instead of two"),
+    llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "in-memory". Keep intermediate sources in memory between stages
+static llvm::cl::opt<bool> InMemory(
+    "in-memory", llvm::cl::Optional,
+    llvm::cl::desc("Keep the intermediate sources in memory between stages and write the results to the output "
+                   "directory once at the end"),
+    llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "stream-macros". Use the streaming macro rewriter
+static llvm::cl::opt<bool> StreamMacros(
+    "stream-macros", llvm::cl::Optional,
+    llvm::cl::desc("Expand macros with a streaming rewriter that does not hold the token stream and the rewritten file "
+                   "in memory, instead of clang's RewriteMacrosInInput"),
+    llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "shard". Analyze a subset of the translation units in a separate process
+static llvm::cl::opt<std::string> Shard(
+    "shard", llvm::cl::Optional,
+    llvm::cl::desc("Only analyze every N-th input file, starting with the I-th (0-based), in a private copy of the "
+                   "output directory and record the results for --merge-shards. Every shard still preprocesses "
+                   "all input files"),
+    llvm::cl::value_desc("I/N"), llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "merge-shards". Merge the results of --shard runs instead of analyzing
+static llvm::cl::opt<unsigned> MergeShards(
+    "merge-shards", llvm::cl::Optional,
+    llvm::cl::desc("Skip elaboration and analysis. Merge the results of N --shard runs with the same input files and "
+                   "output directory instead, the results are identical to a single-process run. The input files "
+                   "are preprocessed again"),
+    llvm::cl::value_desc("N"), llvm::cl::init(0), llvm::cl::cat(UserCat));
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Frontend user option "time-report". Measure the stages of the run
+static llvm::cl::opt<std::string> TimeReport(
+    "time-report", llvm::cl::ValueOptional,
+    llvm::cl::desc("Report wall time, CPU time and peak memory of each stage, parse and match times of each file and "
+                   "the matches handled by each pass at the end of the run. With =json, the report is written to "
+                   "<out>/vrtlmod-time-report.json instead"),
+    llvm::cl::value_desc("json"), llvm::cl::cat(UserCat));
 
 static llvm::cl::extrahelp CommonHelp(clang::tooling::CommonOptionsParser::HelpMessage);
 
@@ -100,6 +199,27 @@ void auto_argument_adjust(clang::tooling::ClangTool &tool)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// \brief Finish the time report of the run and print or write it
+void write_time_report(const vrtlmod::VrtlmodCore &core)
+{
+    if (!util::timereport::is_enabled())
+    {
+        return;
+    }
+    util::timereport::end_stage();
+    if (TimeReport == "json")
+    {
+        auto file = core.get_output_dir() / "vrtlmod-time-report.json";
+        util::string2file(file, util::timereport::to_json());
+        LOG_OBLIGAT("Time report written to [", file.string(), "]");
+    }
+    else
+    {
+        LOG_OBLIGAT(util::timereport::to_text());
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \brief vrtlmod main()
 int main(int argc, const char **argv)
@@ -119,6 +239,21 @@ int main(int argc, const char **argv)
     }
 #endif
 
+    if (TimeReport.getNumOccurrences() > 0)
+    {
+        if (TimeReport != "" && TimeReport != "json")
+        {
+            LOG_ERROR("Unknown time report format [", TimeReport.c_str(), "], expected --time-report[=json]");
+            return 1;
+        }
+        util::timereport::enable();
+    }
+
+    if (LogFile != "")
+    {
+        util::logging::set_log_file(LogFile);
+    }
+
     if (bool(Silent))
     {
         util::logging::toggle_silent();
@@ -131,7 +266,38 @@ int main(int argc, const char **argv)
         LOG_VERBOSE("Executing verbosely - Verbose output active");
     }
 
-    vrtlmod::VrtlmodCore core(OutputDir.c_str(), SystemC);
+    unsigned shard = 0, shard_count = 0;
+    if (Shard != "")
+    {
+        char slash = 0;
+        std::istringstream in(Shard);
+        if (!(in >> shard >> slash >> shard_count) || slash != '/' || !in.eof() || shard >= shard_count)
+        {
+            LOG_ERROR("Invalid shard [", Shard.c_str(), "], expected I/N with I < N");
+            return 1;
+        }
+        if (bool(Overwrite) || bool(Incremental) || Reinstrument != "" || MergeShards > 0)
+        {
+            LOG_ERROR("--shard can not be combined with --overwrite, --incremental, --reinstrument or --merge-shards");
+            return 1;
+        }
+    }
+    if (MergeShards > 0 && Reinstrument != "")
+    {
+        LOG_ERROR("--merge-shards can not be combined with --reinstrument");
+        return 1;
+    }
+
+    // a shard preprocesses all files, but in its own directory, so shards do not interfere: the analyzed TUs include
+    // headers of other shards. The merge preprocesses once more into the output directory, so the comment and macro
+    // passes run N+1 times in total
+    std::string out_dir = OutputDir;
+    if (shard_count > 0)
+    {
+        out_dir = vrtlmod::VrtlmodCore::get_shard_dir(OutputDir.c_str(), shard).string();
+        fs::create_directories(out_dir);
+    }
+    vrtlmod::VrtlmodCore core(out_dir.c_str(), SystemC);
 
     if (bool(PrintTD))
     {
@@ -144,8 +310,15 @@ int main(int argc, const char **argv)
         LOG_WARNING("Output directory ", OutputDir.c_str(), " doesn't exist! Will be created during execution.");
     }
 
+    if (bool(InMemory))
+    {
+        vrtlmod::FileOverlay::get().enable();
+    }
+
     std::vector<std::string> in_sources = op->getSourcePathList();
 
+    util::timereport::begin_stage("prepare");
+
     // prepare *.cpp /*.cc files: create, de-macro, clean comments.
     auto sources = core.prepare_sources(in_sources, Overwrite);
 
@@ -154,91 +327,263 @@ int main(int argc, const char **argv)
 
     auto srcs_and_headers = sources;
     srcs_and_headers.insert(srcs_and_headers.end(), headers.begin(), headers.end());
-    auto srcs_and_headers_wo_symsh = srcs_and_headers;
 
-    clang::tooling::ClangTool CommentTool(op->getCompilations(), srcs_and_headers);
-    if (!bool(NoAutoInclude))
+    // results depend on the vrtlmod version, the command line and the whitelist besides the file contents
+    std::unique_ptr<vrtlmod::IncrementalCache> cache;
+    if (bool(Incremental))
     {
-        auto_argument_adjust(CommentTool);
+        std::string salt = vrtlmod::get_version();
+        for (int i = 0; i < argc; ++i)
+        {
+            salt = util::concat(salt, "\n", argv[i]);
+        }
+        if (WhiteListXmlFilename != "" && fs::exists(WhiteListXmlFilename.c_str()))
+        {
+            salt = util::concat(salt, "\n", util::file2string(WhiteListXmlFilename.c_str()));
+        }
+        cache = std::make_unique<vrtlmod::IncrementalCache>(fs::path(OutputDir.c_str()) / ".vrtlmod-cache", salt);
     }
-    LOG_INFO("Run CommentTool on sources ...");
-    err = CommentTool.run(vrtlmod::CreateCommentRewritePass(core).get());
-    LOG_INFO("... done");
-
-    // create a new Clang Tool instance for Macro cleanup in source and header files except Verilated Symboltable header
-    // which does not need cleanup, but breaks the MacroTool Lexer
-    // FIXME: MacroTool only breaks for large VRTL models on Symboltable
-    srcs_and_headers_wo_symsh.erase(std::remove_if(srcs_and_headers_wo_symsh.begin(), srcs_and_headers_wo_symsh.end(),
-                                                   [](const auto &x)
-                                                   { return (x.find("__Syms.h") != std::string::npos); }));
-    clang::tooling::ClangTool MacroTool(op->getCompilations(), srcs_and_headers_wo_symsh);
-    if (!bool(NoAutoInclude))
+    auto restore = [&](const std::string &stage, const std::vector<std::string> &files,
+                       const vrtlmod::IncrementalCache::context_t &context = {}) {
+        return cache ? cache->restore(stage, files, context) : files;
+    };
+    auto store = [&](const std::string &stage) {
+        if (cache)
+            cache->store(stage);
+    };
+
+    auto adjust = [&](clang::tooling::ClangTool &tool) {
+        if (!bool(NoAutoInclude))
+        {
+            auto_argument_adjust(tool);
+        }
+        if (cache)
+        {
+            // the cache keys depend on the files a TU includes, let every TU list them
+            tool.appendArgumentsAdjuster(
+                [&](const clang::tooling::CommandLineArguments &args, llvm::StringRef file)
+                {
+                    clang::tooling::CommandLineArguments ret = args;
+                    ret.push_back("-MD");
+                    ret.push_back("-MF");
+                    ret.push_back(cache->get_dependency_file(file.str()).string());
+                    return ret;
+                });
+        }
+    };
+    vrtlmod::ToolRunner runner(op->getCompilations(), Jobs, adjust);
+    vrtlmod::ASTCache ast_cache;
+    if (bool(CacheAst))
     {
-        auto_argument_adjust(MacroTool);
+        runner.set_ast_cache(&ast_cache);
     }
-    LOG_INFO("Run MacroTool on sources ...");
-    err = MacroTool.run(vrtlmod::CreateMacroRewritePass(core).get());
-    LOG_INFO("... done");
 
-    // postprocess *.h / *.hpp files: Remove anonymous structs
-    LOG_INFO("Pre-process headers ...");
-    core.preprocess_headers(headers);
-    LOG_INFO("... done");
+    // the results of TUs restored from the cache are replayed, the other TUs run in batches, all in input order
+    auto run_analysis = [&](const std::string &stage, const std::vector<std::string> &files,
+                            vrtlmod::ASTToolAction *action) {
+        core.set_journal_stage(stage);
+        if (!cache)
+        {
+            return runner.run(files, action);
+        }
+        int ret = 0;
+        std::vector<std::string> batch;
+        auto run_batch = [&]() {
+            if (batch.empty())
+                return;
+            int batch_ret = runner.run(batch, action);
+            for (auto const &file : batch)
+            {
+                if (batch_ret == 0)
+                    cache->save(stage, file, core.get_journal_unit(file));
+            }
+            ret = std::max(ret, batch_ret);
+            batch.clear();
+        };
+        for (auto const &file : files)
+        {
+            std::string data;
+            if (cache->load(stage, file, data))
+            {
+                run_batch();
+                ret = std::max(ret, core.replay_journal_unit(data));
+            }
+            else
+            {
+                batch.push_back(file);
+            }
+        }
+        run_batch();
+        return ret;
+    };
 
-    clang::tooling::ClangTool stage1_ParserTool(op->getCompilations(), srcs_and_headers);
-    if (!bool(NoAutoInclude))
+    if (Reinstrument != "")
     {
-        auto_argument_adjust(stage1_ParserTool);
+        util::timereport::begin_stage("load analysis");
+        LOG_INFO("Load VRTL analysis from previous run ...");
+        err = core.load_analysis(Reinstrument, srcs_and_headers);
+        if (err)
+            return err;
+        LOG_INFO("... done");
     }
-    LOG_INFO("Analyze VRTL sources (elaboration)...");
-    err = stage1_ParserTool.run(vrtlmod::CreateElaboratePass(core).get());
-    LOG_INFO("... done");
-
-    clang::tooling::ClangTool stage2_ParserTool(op->getCompilations(), srcs_and_headers);
-    if (!bool(NoAutoInclude))
+    else
     {
-        auto_argument_adjust(stage2_ParserTool);
-    }
-    LOG_INFO("Analyze VRTL sources for possible injection points ...");
-    err = stage2_ParserTool.run(vrtlmod::CreateAnalyzePass(core).get());
-    LOG_INFO("... done");
+        auto preprocessed = restore("preprocess", srcs_and_headers);
+
+        // the preprocessing passes rewrite files that other TUs include: run them isolated, so every TU sees the
+        // stage's input files, independent of the order (and number of jobs) the TUs run in
+        util::timereport::begin_stage("CommentTool");
+        LOG_INFO("Run CommentTool on sources ...");
+        err = runner.run(preprocessed, vrtlmod::CreateCommentRewritePass(core).get(), true);
+        LOG_INFO("... done");
+
+        // run Macro cleanup on source and header files. clang's RewriteMacrosInInput runs out of memory on the
+        // Verilated Symboltable header of large VRTL models, so only the streaming rewriter cleans it up
+        auto macro_files = preprocessed;
+        if (!bool(StreamMacros))
+        {
+            macro_files.erase(std::remove_if(macro_files.begin(), macro_files.end(),
+                                             [](const auto &x) { return (x.find("__Syms.h") != std::string::npos); }),
+                              macro_files.end());
+        }
+        util::timereport::begin_stage("MacroTool");
+        LOG_INFO("Run MacroTool on sources ...");
+        err = runner.run(macro_files, vrtlmod::CreateMacroRewritePass(core, StreamMacros).get(), true);
+        LOG_INFO("... done");
+        store("preprocess");
+
+        // postprocess *.h / *.hpp files: Remove anonymous structs
+        util::timereport::begin_stage("header preprocessing");
+        LOG_INFO("Pre-process headers ...");
+        core.preprocess_headers(headers);
+        LOG_INFO("... done");
+
+        auto analyzed = srcs_and_headers;
+        if (cache)
+        {
+            core.enable_journal();
+        }
+        if (shard_count > 0)
+        {
+            core.enable_journal(shard, shard_count, FusedAnalysis);
+            analyzed.clear();
+            for (size_t i = shard; i < srcs_and_headers.size(); i += shard_count)
+            {
+                analyzed.push_back(srcs_and_headers[i]);
+            }
+            LOG_INFO("Shard ", Shard.c_str(), ": analyzing ", std::to_string(analyzed.size()), " of ",
+                     std::to_string(srcs_and_headers.size()), " files");
+        }
+
+        if (MergeShards > 0)
+        {
+            util::timereport::begin_stage("merge shards");
+            LOG_INFO("Merge VRTL analysis of ", std::to_string(MergeShards), " shards ...");
+            err = core.merge_shards(MergeShards, srcs_and_headers, FusedAnalysis);
+            if (err)
+                return err;
+            LOG_INFO("... done");
+        }
+        else if (bool(FusedAnalysis))
+        {
+            util::timereport::begin_stage("elaboration and analysis");
+            LOG_INFO("Analyze VRTL sources (elaboration and possible injection points)...");
+            core.defer_analysis();
+            err = run_analysis("fused", analyzed, vrtlmod::CreateElaborateAnalyzePass(core).get());
+            core.resolve_deferred_analysis();
+            LOG_INFO("... done");
+        }
+        else
+        {
+            util::timereport::begin_stage("elaboration");
+            LOG_INFO("Analyze VRTL sources (elaboration)...");
+            // The elaboration registers the symbol table instances (see ElaboratePass), which may come before their
+            // module in another translation unit. Without deferring them, these instances and their targets are lost.
+            core.defer_analysis();
+            err = run_analysis("elaborate", analyzed, vrtlmod::CreateElaboratePass(core).get());
+            core.resolve_deferred_analysis();
+            LOG_INFO("... done");
+
+            util::timereport::begin_stage("analysis");
+            LOG_INFO("Analyze VRTL sources for possible injection points ...");
+            err = run_analysis("analyze", analyzed, vrtlmod::CreateAnalyzePass(core).get());
+            LOG_INFO("... done");
+        }
 
-    core.build_xml();
+        if (shard_count > 0)
+        {
+            // the XML, the rewrites and the API are left to --merge-shards
+            err = core.save_journal();
+            write_time_report(core);
+            return err;
+        }
+
+        util::timereport::begin_stage("XML build");
+        core.build_xml();
+        if (bool(SaveSnapshot) || bool(Incremental))
+        {
+            core.save_analysis_snapshot(srcs_and_headers);
+        }
+    }
 
     if (bool(XmlOnly))
+    {
+        vrtlmod::FileOverlay::get().flush();
+        write_time_report(core);
         return 0;
+    }
 
-    core.initialize_injection_targets(WhiteListXmlFilename);
+    util::timereport::begin_stage("filtering");
+    core.initialize_injection_targets(WhiteListXmlFilename,
+                                    std::vector<std::string>(WhiteListPatterns.begin(), WhiteListPatterns.end()));
 
-    clang::tooling::ClangTool stage3_InjectionExprRewriterTool(op->getCompilations(), sources);
-    if (!bool(NoAutoInclude))
+    // the rewrite of a file only depends on its content, the files it includes and its part of the analysis result
+    std::map<std::string, std::string> fragments;
+    if (cache)
     {
-        auto_argument_adjust(stage3_InjectionExprRewriterTool);
+        fragments = core.get_analysis_fragments();
     }
+    auto fragment = [&](const std::string &file) {
+        auto it = fragments.find(vrtlmod::FileOverlay::get_key(file));
+        return (it != fragments.end()) ? it->second : std::string();
+    };
+
+    util::timereport::begin_stage("injection rewrite");
     LOG_INFO("Rewrite VRTL sources for injection points ...");
-    err = stage3_InjectionExprRewriterTool.run(vrtlmod::CreateInjectionPass(core).get());
+    err = runner.run(restore("inject", sources, fragment), vrtlmod::CreateInjectionPass(core).get());
+    store("inject");
     LOG_INFO("... done");
 
+    util::timereport::begin_stage("declaration rewrite");
     LOG_INFO("Rewrite VRTL headers for injectable signals ...");
-    for (auto const &header_file : headers)
-    {
-        clang::tooling::ClangTool stage3_SigDeclRewriterTool(op->getCompilations(), { header_file });
-        if (!bool(NoAutoInclude))
-        {
-            auto_argument_adjust(stage3_SigDeclRewriterTool);
-        }
-        err = stage3_SigDeclRewriterTool.run(vrtlmod::CreateSignalDeclPass(core).get());
-    }
+    err = runner.run(restore("declare", headers, fragment), vrtlmod::CreateSignalDeclPass(core).get(), true);
+    store("declare");
     LOG_INFO("... done");
 
+    util::timereport::begin_stage("API generation");
     LOG_INFO("Generate API ...");
     core.build_api();
     LOG_INFO("... done");
 
     // postprocess *.h / *.hpp files: Reintroduce anonymous structs
+    util::timereport::begin_stage("postprocess");
     LOG_INFO("Postprocess modified sources ...");
     core.postprocess_headers(headers);
+    vrtlmod::FileOverlay::get().flush();
     LOG_INFO("... done");
 
+    if (cache)
+    {
+        cache->prune();
+        LOG_INFO("Incremental cache: ", std::to_string(cache->get_hits()), " restored, ",
+                 std::to_string(cache->get_misses()), " processed stage results");
+    }
+    if (bool(CacheAst))
+    {
+        LOG_INFO("AST cache: ", std::to_string(ast_cache.get_hits()), " reused, ",
+                 std::to_string(ast_cache.get_misses()), " parsed translation units");
+    }
+
+    write_time_report(core);
     return err;
 }
@@ -46,6 +46,13 @@ void ElaboratePass::action(const VrtlParser &parser, const clang::ast_matchers::
     if (const clang::FieldDecl *x = Result.Nodes.getNodeAs<clang::FieldDecl>("instance_decl"))
     {
         LOG_VERBOSE("{instance_decl}: ", x->getNameAsString(), "\n  \\-", parser.get_source_code_str(x));
+        // The assignment matchers only match within sequential functions, so the analysis no longer sees instances
+        // that are only referenced elsewhere, e.g., in port connections. Register all of them here instead, which
+        // keeps the cells and with them the target instances of the API.
+        if (const auto *module = x->getType()->getAsCXXRecordDecl())
+        {
+            get_core().add_module_instance(x, module, *ctx);
+        }
     }
     if (const clang::FieldDecl *x = Result.Nodes.getNodeAs<clang::FieldDecl>("cell_decl"))
     {
@@ -61,10 +68,9 @@ void ElaboratePass::action(const VrtlParser &parser, const clang::ast_matchers::
         LOG_VERBOSE("{topref_decl}: ", x->getNameAsString(), "\n  \\-", parser.get_source_code_str(x));
         if (const auto *module = Result.Nodes.getNodeAs<clang::CXXRecordDecl>("module"))
         {
-            if (const auto *cell = get_core().set_top_cell(x, *ctx))
+            if (const auto *cell = get_core().set_top_cell(x, module, *ctx))
             {
                 LOG_INFO("{top cell} found top cell [", cell->get_id(), "] of type [", cell->get_type(), "]");
-                get_core().add_module_instance(x, module, *ctx);
             }
         }
     }
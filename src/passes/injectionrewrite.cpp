@@ -24,6 +24,10 @@
 
 #include "vrtlmod/util/logging.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
 namespace vrtlmod
 {
 namespace passes
@@ -37,6 +41,13 @@ std::string get_synchronous_injection_stmt(const types::Target &t);
 /// \param t Reference to Target
 /// \param subscripts Subscipts for array-based assignments. Empty vector if trivial
 std::string get_sequent_injection_stmt(const types::Target &t, std::vector<std::string> subscripts);
+///////////////////////////////////////////////////////////////////////
+/// \brief Returns the injection statement, guarded by the armed flag of the target instance, wrapped into the
+/// VRTLMOD_INJECT() switch of the target dictionary, see targetdictionary.hpp
+/// \param prefix Prefix of the target's VRTL members
+/// \param t Reference to Target
+/// \param stmt Injection statement without the prefix
+std::string get_switched_injection_stmt(const std::string &prefix, const types::Target &t, const std::string &stmt);
 
 void InjectionRewriter::action(const VrtlParser &parser,
                                const clang::ast_matchers::MatchFinder::MatchResult &Result) const
@@ -78,8 +89,7 @@ void InjectionRewriter::action(const VrtlParser &parser,
                 if (active_sequent_func_ != nullptr)
                 {
                     auto compound = std::make_shared<CompoundStmt>(c, parser);
-                    active_compound_ = compound.get();
-                    map_seq_compounds_.at(active_sequent_func_).push_back(compound);
+                    active_compound_ = map_seq_compounds_.at(active_sequent_func_).insert(compound).get();
                 }
                 // TODO: maybe add here a locator to the needed sequent function to assign this compound to instead of
                 // leaving on FATAL.
@@ -93,8 +103,7 @@ void InjectionRewriter::action(const VrtlParser &parser,
             if (active_sequent_func_ != nullptr)
             {
                 auto compound = std::make_shared<CompoundStmt>(c, parser);
-                active_compound_ = compound.get();
-                map_seq_compounds_.at(active_sequent_func_).push_back(compound);
+                active_compound_ = map_seq_compounds_.at(active_sequent_func_).insert(compound).get();
             }
         }
     }
@@ -357,7 +366,7 @@ void InjectionRewriter::action(const VrtlParser &parser,
             {
                 // array subscript
                 LOG_INFO("{sea_binary_array_3d}:", util::logging::dump_to_str<const clang::Stmt *>(x, ctx));
-                if (const auto *narrow = Result.Nodes.getNodeAs<clang::ArraySubscriptExpr>("array"))
+                if (const auto *narrow = Result.Nodes.getNodeAs<clang::ArraySubscriptExpr>("array_1d"))
                 {
                     LOG_INFO("{array_1d}:", util::logging::dump_to_str<const clang::Stmt *>(narrow, ctx));
                     auto idx_1d = narrow->getIdx();
@@ -515,31 +524,74 @@ std::vector<std::shared_ptr<InjectionRewriter::SInj>> InjectionRewriter::Compoun
     void) const
 {
     std::vector<std::shared_ptr<InjectionRewriter::SInj>> ret{};
+    std::unordered_map<std::string, std::vector<size_t>> ret_by_lhsstr{}; ///< indices in ret per assigned expression
 
     for (auto const &outer : asngs_)
     {
-        std::string outer_lhsstr =
-            parser_.getRewriter().getRewrittenText(outer->get_base_expr()->getSourceRange()).c_str();
+        std::string outer_lhsstr = parser_.getRewriter().getRewrittenText(outer->get_base_expr()->getSourceRange());
         auto outer_begin = outer->get_base_expr()->getBeginLoc();
         bool found = false;
 
-        for (auto &inner : ret)
+        auto &same_lhs = ret_by_lhsstr[outer_lhsstr];
+        for (auto idx : same_lhs)
         {
-            auto inner_begin = inner->get_base_expr()->getBeginLoc();
-            if (inner_begin < outer_begin)
+            auto &inner = ret[idx];
+            if (inner->get_base_expr()->getBeginLoc() < outer_begin)
             {
-                std::string inner_lhsstr =
-                    parser_.getRewriter().getRewrittenText(inner->get_base_expr()->getSourceRange()).c_str();
-                if (outer_lhsstr == inner_lhsstr)
-                {
-                    inner = outer; // replace the last occurence with this latest one (dominant in sequential compound.)
-                    found = true;
-                    break;
-                }
+                inner = outer; // replace the last occurence with this latest one (dominant in sequential compound.)
+                found = true;
+                break;
             }
         }
         if (!found)
+        {
+            same_lhs.push_back(ret.size());
             ret.push_back(outer);
+        }
+    }
+    return ret;
+}
+
+std::shared_ptr<InjectionRewriter::CompoundStmt> InjectionRewriter::CompoundTree::insert(
+    std::shared_ptr<CompoundStmt> compound)
+{
+    std::shared_ptr<CompoundStmt> parent = find_finest(compound->begin(), compound->end());
+    if (parent && parent->c_ == compound->c_)
+    {
+        return parent;
+    }
+    auto &level = parent ? parent->children_ : roots_;
+    auto pos = std::upper_bound(level.begin(), level.end(), compound->begin(),
+                                [](unsigned begin, const auto &c) { return begin < c->begin(); });
+    // compounds are matched in traversal order, i.e., before the ones nested in them. Still, adopt any following
+    // siblings that are nested in the new compound to keep the levels disjoint.
+    auto nested_end = pos;
+    while (nested_end != level.end() && (*nested_end)->end() <= compound->end())
+    {
+        ++nested_end;
+    }
+    compound->children_.insert(compound->children_.end(), pos, nested_end);
+    pos = level.erase(pos, nested_end);
+    level.insert(pos, compound);
+    return compound;
+}
+
+std::shared_ptr<InjectionRewriter::CompoundStmt> InjectionRewriter::CompoundTree::find_finest(unsigned begin,
+                                                                                           unsigned end) const
+{
+    std::shared_ptr<CompoundStmt> ret{ nullptr };
+    const auto *level = &roots_;
+    while (!level->empty())
+    {
+        // the only candidate of a level is the last compound starting before (or at) the range
+        auto it = std::upper_bound(level->begin(), level->end(), begin,
+                                   [](unsigned b, const auto &c) { return b < c->begin(); });
+        if (it == level->begin() || (*std::prev(it))->end() < end)
+        {
+            break;
+        }
+        ret = *std::prev(it);
+        level = &ret->children_;
     }
     return ret;
 }
@@ -599,8 +651,7 @@ void InjectionRewriter::BinarySInj::rewrite_injection(const VrtlParser &parser,
     }
     else
     {
-        str += prefix_;
-        str += get_sequent_injection_stmt(*t_, subscripts);
+        str += get_switched_injection_stmt(prefix_, *t_, get_sequent_injection_stmt(*t_, subscripts));
     }
 
     LOG_INFO("Writing sequential injection point [", str, "] for target: ", t_->_self());
@@ -621,8 +672,7 @@ void InjectionRewriter::CallSInj::rewrite_injection(const VrtlParser &parser, bo
     }
     else
     {
-        str += prefix_;
-        str += get_synchronous_injection_stmt(*t_);
+        str += get_switched_injection_stmt(prefix_, *t_, get_synchronous_injection_stmt(*t_));
     }
 
     parser.getRewriter().ReplaceText(expr_->getSourceRange(), str);
@@ -637,26 +687,22 @@ void InjectionRewriter::wrap_up_sequent_function(const clang::FunctionDecl *func
     auto &ts = map_injected_targets_.at(func);
     LOG_INFO("INJREW Adding non-dominant injection points to end of sequential function:", func->getNameAsString());
 
-    std::string newc = parser.getRewriter().getRewrittenText(func->getSourceRange());
-
     LOG_VERBOSE("{compset}: of func ", func->getNameAsString());
     insert << std::endl << "    //>>> vRTLmod non-dominant target injections" << std::endl;
 
     for (auto const &it : ts)
     {
         LOG_VERBOSE("\\-> target ", it.second->_self());
-        insert << "    " << it.first << get_synchronous_injection_stmt(*(it.second)) << ";" << std::endl;
+        const types::Target &t = *(it.second);
+        insert << "    " << get_switched_injection_stmt(it.first, t, get_synchronous_injection_stmt(t)) << ";"
+               << std::endl;
     }
     insert << "    //<<< VRTLFI non-dominant target injections" << std::endl;
-    insert << "}";
 
-    // find last '}' as function body end
-    auto posLastBr = newc.rfind("}");
-    if (posLastBr != std::string::npos)
+    // insert in front of the function body's closing '}', the function itself stays untouched
+    if (const auto *body = llvm::dyn_cast_or_null<clang::CompoundStmt>(func->getBody()))
     {
-        newc.erase(posLastBr);
-        newc.append(insert.str());
-        parser.getRewriter().ReplaceText(func->getSourceRange(), newc);
+        parser.getRewriter().InsertTextAfter(body->getRBracLoc(), insert.str());
     }
 }
 
@@ -684,61 +730,31 @@ void InjectionRewriter::write_sequent_injections(void) const
 {
     for (auto const &[seq_func, seq_compounds] : map_seq_compounds_)
     {
-        for (auto const &compound : seq_compounds)
-        {
-            auto dominant_asgns = compound->get_dominant_assignments();
-            for (auto const sinj : dominant_asgns)
+        auto &ts = map_nonliteral_subscript_targets_.at(seq_func);
+        seq_compounds.foreach_bottom_up(
+            [&](const CompoundStmt &compound)
             {
-                // find target in map_nonliteral_subscript_targets_, if so skip sequential injection
-                bool skip = false;
-                auto &ts = map_nonliteral_subscript_targets_.at(seq_func);
-                for (auto const &[prefix, target] : ts)
+                auto dominant_asgns = compound.get_dominant_assignments();
+                for (auto const sinj : dominant_asgns)
                 {
-                    skip |= (target == sinj->t_) && (prefix == sinj->prefix_);
-                    if (skip)
-                    {
-                        break;
-                    }
+                    // find target in map_nonliteral_subscript_targets_, if so skip sequential injection
+                    bool skip = ts.find({ sinj->prefix_, sinj->t_ }) != ts.end();
+                    sinj->rewrite_injection(compound.parser_, skip);
                 }
-                sinj->rewrite_injection(compound->parser_, skip);
-            }
-        }
+            });
     }
 }
 
 std::shared_ptr<InjectionRewriter::CompoundStmt> InjectionRewriter::get_finest_compound(const clang::FunctionDecl *f,
                                                                                         const clang::Expr *expr) const
 {
-    std::shared_ptr<CompoundStmt> ret{ nullptr };
-    auto in_range = [](const clang::Expr *a, const auto *b) -> bool
-    {
-        if ((a->getBeginLoc().getRawEncoding() >= b->getBeginLoc().getRawEncoding()) &&
-            (a->getEndLoc().getRawEncoding() <= b->getEndLoc().getRawEncoding()))
-        {
-            return true;
-        }
-        return false;
-    };
-
-    for (auto &comp : map_seq_compounds_.at(f))
-    {
-        if (in_range(expr, comp->c_))
-        {
-            if (!ret)
-            {
-                ret = comp; // none found yet
-            }
-            else
-            {
-                if (ret->c_->getBeginLoc() < comp->c_->getBeginLoc())
-                {
-                    ret = comp; // one more fine grain comp found
-                }
-            }
-        }
-    }
+    return map_seq_compounds_.at(f).find_finest(expr->getBeginLoc().getRawEncoding(),
+                                                expr->getEndLoc().getRawEncoding());
+}
 
-    return ret;
+std::string get_switched_injection_stmt(const std::string &prefix, const types::Target &t, const std::string &stmt)
+{
+    return util::concat("VRTLMOD_INJECT(if (*", prefix, t.get_id(), "__armed_) ", prefix, stmt, ")");
 }
 
 std::string get_sequent_injection_stmt(const types::Target &t, std::vector<std::string> subscripts)
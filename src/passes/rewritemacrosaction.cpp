@@ -20,9 +20,13 @@
 
 #include "vrtlmod/passes/rewritemacrosaction.hpp"
 
+#include "vrtlmod/core/toolrunner.hpp"
 #include "vrtlmod/util/logging.hpp"
 #include "vrtlmod/util/utility.hpp"
 
+#include <deque>
+#include <map>
+
 namespace vrtlmod
 {
 namespace transform
@@ -30,22 +34,233 @@ namespace transform
 namespace rewrite
 {
 
-RewriteMacrosAction::RewriteMacrosAction() {}
+namespace
+{
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Raw (unpreprocessed) tokens of the main file, lexed on demand with a small lookahead
+class RawTokenStream
+{
+    clang::Preprocessor &pp_;
+    clang::Lexer lex_;
+    std::deque<clang::Token> ahead_;
+
+    static clang::Lexer create_lexer(clang::Preprocessor &pp)
+    {
+        clang::SourceManager &sm = pp.getSourceManager();
+#if LLVM_VERSION_MAJOR < 12
+        return clang::Lexer(sm.getMainFileID(), sm.getBuffer(sm.getMainFileID()), sm, pp.getLangOpts());
+#else
+        return clang::Lexer(sm.getMainFileID(), sm.getBufferOrFake(sm.getMainFileID()), sm, pp.getLangOpts());
+#endif
+    }
+
+    void fill(size_t n)
+    {
+        while (ahead_.size() < n)
+        {
+            if (!ahead_.empty() && ahead_.back().is(clang::tok::eof))
+            {
+                ahead_.push_back(ahead_.back());
+                continue;
+            }
+            clang::Token tok;
+            lex_.LexFromRawLexer(tok);
+            // identifier info is needed to compare raw identifiers with preprocessed ones
+            if (tok.is(clang::tok::raw_identifier))
+            {
+                pp_.LookUpIdentifierInfo(tok);
+            }
+            ahead_.push_back(tok);
+        }
+    }
+
+  public:
+    RawTokenStream(clang::Preprocessor &pp) : pp_(pp), lex_(create_lexer(pp)) { lex_.SetCommentRetentionState(true); }
+
+    const clang::Token &peek(size_t n)
+    {
+        fill(n + 1);
+        return ahead_[n];
+    }
+    clang::Token next(bool return_comment)
+    {
+        if (!return_comment && peek(0).is(clang::tok::comment))
+        {
+            ahead_.pop_front();
+        }
+        clang::Token ret = peek(0);
+        ahead_.pop_front();
+        return ret;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Copies the main file to an output stream while inserting text
+/// @details Insertions are held back until commit() guarantees that no insertion in front of them follows, so only the
+///          insertions between the current raw and preprocessed token are buffered, independent of the file size.
+class StreamingInserter
+{
+    llvm::StringRef src_;
+    llvm::raw_ostream &os_;
+    size_t written_{ 0 };
+    std::map<size_t, std::string> pending_; ///< offset -> text inserted in front of it
+
+  public:
+    StreamingInserter(llvm::StringRef src, llvm::raw_ostream &os) : src_(src), os_(os) {}
+
+    void insert_before(size_t offs, llvm::StringRef text) { pending_[offs].insert(0, text.str()); }
+    void insert_after(size_t offs, llvm::StringRef text) { pending_[offs] += text.str(); }
+    ///////////////////////////////////////////////////////////////////////
+    /// \brief Write everything in front of offs, no later insertion may go there
+    void commit(size_t offs)
+    {
+        auto end = pending_.lower_bound(offs);
+        for (auto it = pending_.begin(); it != end; ++it)
+        {
+            os_ << src_.slice(written_, it->first) << it->second;
+            written_ = it->first;
+        }
+        pending_.erase(pending_.begin(), end);
+        if (offs > written_)
+        {
+            os_ << src_.slice(written_, offs);
+            written_ = offs;
+        }
+    }
+    void finish(void)
+    {
+        commit(src_.size());
+        for (auto const &it : pending_)
+        {
+            os_ << it.second;
+        }
+        pending_.clear();
+    }
+};
+
+bool is_same_token(const clang::Token &raw, const clang::Token &pp)
+{
+    // keywords and raw lexed identifiers only share their identifier info
+    return (pp.getKind() == raw.getKind() && pp.getIdentifierInfo() == raw.getIdentifierInfo()) ||
+           (pp.getIdentifierInfo() && pp.getIdentifierInfo() == raw.getIdentifierInfo());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Streaming equivalent of clang::RewriteMacrosInInput
+/// @details Walks the raw and the preprocessed token stream of the main file in lockstep, comments out macro uses and
+///          inserts their expansions. Unlike clang::RewriteMacrosInInput, neither the token stream nor the rewritten
+///          file are materialized, and files without macros are copied unchanged.
+void stream_macro_expansions(clang::Preprocessor &pp, llvm::raw_ostream &os)
+{
+    clang::SourceManager &sm = pp.getSourceManager();
+    StreamingInserter out(sm.getBufferData(sm.getMainFileID()), os);
+    RawTokenStream raw(pp);
+    clang::Token raw_tok = raw.next(false);
+
+    pp.EnterMainSourceFile();
+    clang::Token pp_tok;
+    pp.Lex(pp_tok);
+
+    while (raw_tok.isNot(clang::tok::eof) || pp_tok.isNot(clang::tok::eof))
+    {
+        clang::SourceLocation pp_loc = sm.getExpansionLoc(pp_tok.getLocation());
+        if (!sm.isWrittenInMainFile(pp_loc)) // token of an included file
+        {
+            pp.Lex(pp_tok);
+            continue;
+        }
+        unsigned pp_offs = sm.getFileOffset(pp_loc);
+        unsigned raw_offs = sm.getFileOffset(raw_tok.getLocation());
+        out.commit(std::min(pp_offs, raw_offs));
+
+        // keep preprocessor directives, but comment out #warning and #pragma mark
+        if (raw_tok.is(clang::tok::hash) && raw_tok.isAtStartOfLine())
+        {
+            if (raw.peek(0).is(clang::tok::identifier))
+            {
+                llvm::StringRef directive = raw.peek(0).getIdentifierInfo()->getName();
+                if (directive == "warning" ||
+                    (directive == "pragma" && raw.peek(1).is(clang::tok::identifier) &&
+                     raw.peek(1).getIdentifierInfo()->getName() == "mark"))
+                {
+                    out.insert_after(raw_offs, "//");
+                }
+            }
+            do
+            {
+                raw_tok = raw.next(false);
+            } while (!raw_tok.isAtStartOfLine() && raw_tok.isNot(clang::tok::eof));
+            continue;
+        }
+
+        if (pp_offs == raw_offs && is_same_token(raw_tok, pp_tok))
+        {
+            raw_tok = raw.next(false);
+            pp.Lex(pp_tok);
+            continue;
+        }
+
+        // raw tokens in front of the preprocessed one were removed by a macro: comment out the whole run
+        if (raw_offs <= pp_offs)
+        {
+            out.insert_after(raw_offs, raw_tok.hasLeadingSpace() ? "/*" : " /*");
+            unsigned end_offs;
+            do
+            {
+                end_offs = raw_offs + raw_tok.getLength();
+                raw_tok = raw.next(true);
+                raw_offs = sm.getFileOffset(raw_tok.getLocation());
+                if (raw_tok.is(clang::tok::comment))
+                {
+                    raw_tok = raw.next(false);
+                    break;
+                }
+            } while (raw_offs <= pp_offs && !raw_tok.isAtStartOfLine() &&
+                     (pp_offs != raw_offs || !is_same_token(raw_tok, pp_tok)));
+            out.insert_before(end_offs, "*/");
+            continue;
+        }
+
+        // preprocessed tokens in front of the raw one are a macro expansion: insert the whole run at once
+        unsigned insert_offs = pp_offs;
+        std::string expansion;
+        while (pp_offs < raw_offs)
+        {
+            expansion += ' ' + pp.getSpelling(pp_tok);
+            pp.Lex(pp_tok);
+            pp_offs = sm.getFileOffset(sm.getExpansionLoc(pp_tok.getLocation()));
+        }
+        expansion += ' ';
+        out.insert_before(insert_offs, expansion);
+    }
+    out.finish();
+}
+} // namespace
+
+RewriteMacrosAction::RewriteMacrosAction(bool streaming) : streaming_(streaming) {}
 
 void RewriteMacrosAction::ExecuteAction()
 {
     LOG_VERBOSE("> Rewrite Macros file", getCurrentFile().str());
 
-    clang::CompilerInstance &CI = getCompilerInstance();
-    std::stringstream buffer;
-    llvm::raw_os_ostream rout(buffer);
+    clang::Preprocessor &PP = getCompilerInstance().getPreprocessor();
+    if (streaming_)
+    {
+        ToolRunner::write_file(getCurrentFile().str(), [&](llvm::raw_ostream &os) { stream_macro_expansions(PP, os); });
+        return;
+    }
 
-    RewriteMacrosInInput(CI.getPreprocessor(), &rout);
+    std::string buffer;
+    llvm::raw_string_ostream rout(buffer);
+    clang::RewriteMacrosInInput(PP, &rout);
     rout.flush();
-    std::ofstream out(getCurrentFile().str().c_str());
-    out << buffer.str();
-    out.flush();
-    out.close();
+    // RewriteMacrosInInput writes nothing for files without macro uses, keep those unchanged
+    if (buffer.empty())
+    {
+        clang::SourceManager &SM = PP.getSourceManager();
+        buffer = SM.getBufferData(SM.getMainFileID()).str();
+    }
+    ToolRunner::write_file(getCurrentFile().str(), [&](llvm::raw_ostream &os) { os << buffer; });
 }
 
 void RewriteCommentsAction::ExecuteAction(void)
@@ -63,13 +278,15 @@ void RewriteCommentsAction::ExecuteAction(void)
     ch_.set_rewrite_buffer(RB);
     CI.getPreprocessor().addCommentHandler(&ch_);
 
-    llvm::raw_null_ostream null_out;
-    RewriteMacrosInInput(CI.getPreprocessor(), &null_out);
+    // the comment handler only needs the preprocessor to see every comment, lex the file without rewriting it
+    PP.EnterMainSourceFile();
+    clang::Token tok;
+    do
+    {
+        PP.Lex(tok);
+    } while (tok.isNot(clang::tok::eof));
 
-    std::ofstream out(getCurrentFile().str().c_str());
-    out << std::string(RB.begin(), RB.end());
-    out.flush();
-    out.close();
+    ToolRunner::write_file(getCurrentFile().str(), [&](llvm::raw_ostream &os) { RB.write(os); });
     CI.getPreprocessor().removeCommentHandler(&ch_);
 }
 
@@ -78,7 +295,6 @@ bool RewriteCommentsAction::CommentHandler::HandleComment(clang::Preprocessor &P
     clang::SourceManager &sm = PP.getSourceManager();
     if (sm.getFilename(Comment.getBegin()) == file_)
     {
-        auto comment_loc_str = Comment.printToString(sm);
         std::pair<clang::FileID, unsigned int> startLoc = sm.getDecomposedLoc(Comment.getBegin());
         std::pair<clang::FileID, unsigned int> endLoc = sm.getDecomposedLoc(Comment.getEnd());
 
@@ -91,11 +307,7 @@ bool RewriteCommentsAction::CommentHandler::HandleComment(clang::Preprocessor &P
         // some text */ ...  */ which breaks preprocessor at first /**/ pair
         if (auto inline_pos_start = comment_str.find("/*", 2); inline_pos_start != std::string::npos)
         {
-            clang::Rewriter rw;
-            rw.setSourceMgr(sm, PP.getLangOpts());
-            rewrite_buffer_t &RB = rw.getEditBuffer(sm.getMainFileID());
-
-            std::cout << ">>>[c]: was `" << comment_str << "`" << std::endl;
+            LOG_VERBOSE(">>>[c]: was `", comment_str, "`");
             std::string new_str;
             new_str = comment_str.substr(2);
             util::strhelp::replaceAll(new_str, "/*", "\\/\\*");
@@ -46,6 +46,22 @@ void SignalDeclRewriter::action(const VrtlParser &parser,
 
     if (const clang::FieldDecl *x = Result.Nodes.getNodeAs<clang::FieldDecl>("signal_decl"))
     {
+        // every header is rewritten by its own TU only, so TUs never write files included by other TUs
+        if (!srcmgr.isInMainFile(x->getLocation()))
+        {
+            std::string file = LOCATABLE_GET_FILENAME_FROM_CLANG(x->getLocation(), srcmgr).str();
+            if (!get_core().is_input_file(file))
+            {
+                // no TU rewrites headers that are not inputs, the target would silently never be injected
+                auto target_index = get_core().is_decl_target(x);
+                if (target_index >= 0 && get_core().get_target_from_index(target_index).is_declared_here(x))
+                {
+                    LOG_FATAL("Injection target [", x->getNameAsString(), "] is declared in [", file,
+                              "], which is not an input file. Pass all headers of the VRTL to vrtlmod.");
+                }
+            }
+            return;
+        }
         LOG_VERBOSE("{signal_decl}: ", x->getNameAsString(), "\n  `\\-", get_source_code_str(x));
         LOG_VERBOSE("AST:\n", util::logging::dump_to_str(x));
 
@@ -74,8 +90,8 @@ void SignalDeclRewriter::write_injection_decl(const clang::FieldDecl *decl, cons
     x << parser.getRewriter().getRewrittenText(decl->getSourceRange()) << "; ";
     x << "vrtlfi::td::";
 
-    auto cxxdim = t.get_cxx_dimension_lengths();
-    auto cxxdimtypes = t.get_cxx_dimension_types();
+    const auto &cxxdim = t.get_cxx_dimension_lengths();
+    const auto &cxxdimtypes = t.get_cxx_dimension_types();
 
     switch (cxxdim.size())
     {
@@ -101,6 +117,8 @@ void SignalDeclRewriter::write_injection_decl(const clang::FieldDecl *decl, cons
         LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
         break;
     }
+    // slot of the target instance in the API's compact armed array, see vrtlfi::td::TD_API::armed_
+    x << "; const bool *" << t.get_id() << "__armed_ = vrtlfi::td::never_armed()";
 
     parser.getRewriter().ReplaceText(decl->getSourceRange(), x.str());
     modify_includes(decl, parser);
@@ -108,44 +126,29 @@ void SignalDeclRewriter::write_injection_decl(const clang::FieldDecl *decl, cons
 
 void SignalDeclRewriter::modify_includes(const clang::Decl *decl, const VrtlParser &parser) const
 {
-    auto& srcmgr = parser.getRewriter().getSourceMgr();
-
-    FileID fid = srcmgr.getFileID(decl->getBeginLoc());
-#if LLVM_VERSION_MAJOR < 17
-    static std::set<const FileEntry*> modified_fentries{};
-    const FileEntry* fentry = srcmgr.getFileEntryForID(fid);
-#else
-    static std::set<FileEntryRef> modified_fentries{};
-    clang::OptionalFileEntryRef maybeFEntry = srcmgr.getFileEntryRefForID(fid);
-    if (!maybeFEntry) {
-        LOG_FATAL(">modify includes: file[", LOCATABLE_GET_FILENAME_FROM_CLANG(decl->getBeginLoc(), srcmgr).str(), "] no File Reference found in Source Manager.");
-    }
-    clang::FileEntryRef fentry = *maybeFEntry;
-#endif
-    if (modified_fentries.find(fentry) != modified_fentries.end())
+    if (includes_modified_)
     {
-        LOG_VERBOSE(">modify includes: file[", LOCATABLE_GET_FILENAME_FROM_CLANG(decl->getBeginLoc(), srcmgr).str(), "] already modified. skipping.");
-        return; // already modified
+        return; // only declarations of the main file are rewritten, one include per TU suffices
     }
+    auto &srcmgr = parser.getRewriter().getSourceMgr();
 
-    SourceLocation flocSOF = srcmgr.getLocForStartOfFile(fid);
-    SourceRange flocra = SourceRange(flocSOF, srcmgr.getLocForEndOfFile(fid));
-
-    std::string newc = parser.getRewriter().getRewrittenText(flocra);
-    auto includepos = newc.find("#include");
-    if (includepos != std::string::npos)
+    FileID fid = srcmgr.getFileID(decl->getBeginLoc());
+    // the includes precede every rewrite of this pass, so we can search the file buffer and insert at its location
+    llvm::StringRef buffer = srcmgr.getBufferData(fid);
+    auto includepos = buffer.find("#include");
+    if (includepos != llvm::StringRef::npos)
     {
-        LOG_VERBOSE(">modify includes: file[", LOCATABLE_GET_FILENAME_FROM_CLANG(decl->getBeginLoc(), srcmgr).str(), "] at pos[", std::to_string(includepos), "]");
+        LOG_VERBOSE(">modify includes: file[", LOCATABLE_GET_FILENAME_FROM_CLANG(decl->getBeginLoc(), srcmgr).str(),
+                    "] at pos[", std::to_string(includepos), "]");
         std::string x = get_core().get_include_string();
-        if (newc.find(x) == std::string::npos) // do not insert if already existing
+        if (buffer.find(x) == llvm::StringRef::npos) // do not insert if already existing
         {
-            newc.insert(includepos, x);
             // parser.getRewriter().InsertTextBefore(flocSOF, get_core().getTDExternalDecl()); // todo this was
             // previously used for the global singleton, we no longer need because injection points are incorporated in
             // the VRTL class definition
-            parser.getRewriter().ReplaceText(flocra, newc);
-            modified_fentries.insert(fentry);
+            parser.getRewriter().InsertTextBefore(srcmgr.getLocForStartOfFile(fid).getLocWithOffset(includepos), x);
         }
+        includes_modified_ = true;
     }
 }
 
@@ -22,8 +22,12 @@
 #include "vrtlmod/util/logging.hpp"
 
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <mutex>
+#include <vector>
 
 namespace util
 {
@@ -31,6 +35,35 @@ namespace util
 namespace logging
 {
 
+bool silent_ = false;
+bool verbose_ = false;
+
+namespace
+{
+std::mutex mtx; // keep lines of concurrent (--jobs) workers apart
+std::vector<char> log_file_buffer; // declared first, so it outlives the stream flushing into it on exit
+std::unique_ptr<std::ofstream> log_file;
+
+const char *toPlainString(LEVEL level)
+{
+    switch (level)
+    {
+    case OBLIGAT:
+        return "";
+    case VERBOSE:
+        return ">";
+    case INFO:
+        return "Info ";
+    case WARNING:
+        return "Warning ";
+    case ERROR:
+        return "Error ";
+    default:
+        return "Unknown ";
+    }
+}
+} // namespace
+
 const char *toString(LEVEL level)
 {
     switch (level)
@@ -59,37 +92,57 @@ void toggle_verbose(void)
     log(VERBOSE, "", false, true);
 }
 
+bool set_log_file(const std::string &file)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    auto out = std::make_unique<std::ofstream>();
+    log_file_buffer.resize(1 << 20);
+    out->rdbuf()->pubsetbuf(log_file_buffer.data(), log_file_buffer.size()); // must precede open()
+    out->open(file);
+    if (!out->is_open())
+    {
+        std::cout << util::concat(toString(ERROR), "Could not open log file [", file, "] \033[0m") << std::endl;
+        return false;
+    }
+    log_file = std::move(out);
+    return true;
+}
+
 void log(LEVEL level, const std::string &msg, bool silent_toggle, bool verbose_toggle)
 {
-    static bool silent = false;
-    static bool verbose = false;
-    std::stringstream x;
     if (silent_toggle)
     {
-        silent = !silent;
+        silent_ = !silent_;
     }
     if (verbose_toggle)
     {
-        verbose = !verbose;
+        verbose_ = !verbose_;
     }
-    if (level == VERBOSE && !verbose)
+    if (silent_toggle || verbose_toggle || !is_enabled(level))
     {
         return;
     }
 
-    if ((silent == false) || ((silent == true) && (level == ERROR or level == OBLIGAT)))
+    std::lock_guard<std::mutex> lock(mtx);
+    if (log_file)
     {
-        switch (level)
+        *log_file << toPlainString(level) << msg << '\n';
+        if (level != ERROR)
         {
-        case ERROR:
-            [[fallthrough]];
-        case WARNING:
-            std::cout << util::concat(toString(level), msg, " \033[0m") << std::endl;
-            break;
-        default:
-            std::cout << util::concat(toString(level), " \033[0m", msg) << std::endl;
-            break;
+            return;
         }
+        log_file->flush(); // keep everything up to a failure
+    }
+    switch (level)
+    {
+    case ERROR:
+        [[fallthrough]];
+    case WARNING:
+        std::cout << util::concat(toString(level), msg, " \033[0m") << std::endl;
+        break;
+    default:
+        std::cout << util::concat(toString(level), " \033[0m", msg) << std::endl;
+        break;
     }
 }
 
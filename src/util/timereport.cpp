@@ -0,0 +1,265 @@
+/*
+ * Copyright 2021 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file timereport.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/util/timereport.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace util
+{
+
+namespace timereport
+{
+
+bool enabled_ = false;
+
+namespace
+{
+struct FileTime
+{
+    double parse_{ 0 };
+    double match_{ 0 };
+};
+
+struct Stage
+{
+    std::string name_;
+    double wall_{ 0 };
+    double cpu_{ 0 };
+    long peak_rss_kib_{ 0 };                ///< peak resident set size of the process at the end of the stage
+    std::map<std::string, FileTime> files_; ///< per translation unit
+    std::map<std::string, size_t> matches_; ///< per parser, i.e., its passes
+};
+
+std::mutex mtx; // files and matches are added by concurrent (--jobs) workers
+std::vector<Stage> stages;
+bool running = false;
+std::chrono::steady_clock::time_point stage_start;
+double stage_cpu_start = 0;
+
+double cpu_seconds(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+long peak_rss_kib(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // bytes
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+std::string format(double value, const char *fmt = "%.3f")
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), fmt, value);
+    return buf;
+}
+
+std::string json_string(const std::string &str)
+{
+    std::string ret = "\"";
+    for (char c : str)
+    {
+        switch (c)
+        {
+        case '"':
+            ret += "\\\"";
+            break;
+        case '\\':
+            ret += "\\\\";
+            break;
+        case '\n':
+            ret += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", unsigned(static_cast<unsigned char>(c)));
+                ret += buf;
+            }
+            else
+            {
+                ret += c;
+            }
+        }
+    }
+    return ret + "\"";
+}
+} // namespace
+
+void enable(void)
+{
+    enabled_ = true;
+}
+
+void begin_stage(const std::string &name)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+    end_stage();
+    std::lock_guard<std::mutex> lock(mtx);
+    stages.push_back(Stage{ name });
+    running = true;
+    stage_cpu_start = cpu_seconds();
+    stage_start = std::chrono::steady_clock::now();
+}
+
+void end_stage(void)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!running)
+    {
+        return;
+    }
+    Stage &s = stages.back();
+    s.wall_ = seconds_since(stage_start);
+    s.cpu_ = cpu_seconds() - stage_cpu_start;
+    s.peak_rss_kib_ = peak_rss_kib();
+    running = false;
+}
+
+void add_file_time(const std::string &file, double parse_seconds, double match_seconds)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (running)
+    {
+        FileTime &t = stages.back().files_[file];
+        t.parse_ += parse_seconds;
+        t.match_ += match_seconds;
+    }
+}
+
+void add_matches(const std::string &passes, size_t count)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (running)
+    {
+        stages.back().matches_[passes] += count;
+    }
+}
+
+std::string to_text(void)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    std::ostringstream ret;
+    ret << "Time report:\n"
+        << "  stage" << std::string(23, ' ') << "  wall [s]   cpu [s]  peak RSS [MiB]\n";
+    double wall = 0, cpu = 0;
+    for (auto const &s : stages)
+    {
+        wall += s.wall_;
+        cpu += s.cpu_;
+        ret << "  " << s.name_ << std::string(s.name_.size() < 28 ? 28 - s.name_.size() : 0, ' ') << " "
+            << format(s.wall_, "%9.3f") << " " << format(s.cpu_, "%9.3f") << " "
+            << format(s.peak_rss_kib_ / 1024.0, "%15.1f") << "\n";
+        for (auto const &it : s.matches_)
+        {
+            ret << "    " << it.first << ": " << it.second << " matches\n";
+        }
+        // slowest files first, they are the ones worth looking at
+        std::vector<std::pair<double, const std::string *>> files;
+        for (auto const &it : s.files_)
+        {
+            files.emplace_back(it.second.parse_ + it.second.match_, &it.first);
+        }
+        std::sort(files.begin(), files.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+        for (size_t i = 0; i < files.size() && i < 5; ++i)
+        {
+            const FileTime &t = s.files_.at(*files[i].second);
+            ret << "    " << *files[i].second << ": parse " << format(t.parse_) << " s, match " << format(t.match_)
+                << " s\n";
+        }
+        if (files.size() > 5)
+        {
+            ret << "    ... " << files.size() - 5 << " more files\n";
+        }
+    }
+    ret << "  total" << std::string(23, ' ') << " " << format(wall, "%9.3f") << " " << format(cpu, "%9.3f");
+    return ret.str();
+}
+
+std::string to_json(void)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    std::ostringstream ret;
+    ret << "{\n  \"stages\": [";
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        const Stage &s = stages[i];
+        ret << (i ? "," : "") << "\n    {\n"
+            << "      \"name\": " << json_string(s.name_) << ",\n"
+            << "      \"wall_seconds\": " << format(s.wall_, "%.6f") << ",\n"
+            << "      \"cpu_seconds\": " << format(s.cpu_, "%.6f") << ",\n"
+            << "      \"peak_rss_kib\": " << s.peak_rss_kib_ << ",\n"
+            << "      \"matches\": {";
+        bool first = true;
+        for (auto const &it : s.matches_)
+        {
+            ret << (first ? "" : ",") << "\n        " << json_string(it.first) << ": " << it.second;
+            first = false;
+        }
+        ret << (first ? "" : "\n      ") << "},\n"
+            << "      \"files\": [";
+        first = true;
+        for (auto const &it : s.files_)
+        {
+            ret << (first ? "" : ",") << "\n        { \"file\": " << json_string(it.first)
+                << ", \"parse_seconds\": " << format(it.second.parse_, "%.6f")
+                << ", \"match_seconds\": " << format(it.second.match_, "%.6f") << " }";
+            first = false;
+        }
+        ret << (first ? "" : "\n      ") << "]\n    }";
+    }
+    ret << (stages.empty() ? "" : "\n  ") << "]\n}\n";
+    return ret.str();
+}
+
+} // namespace timereport
+
+} // namespace util
@@ -20,6 +20,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <array>
+#include <cstdio>
 #include <memory>
 #include <sstream>
 #include <fstream>
@@ -56,21 +57,49 @@ std::string file2string(const fs::path &fpath)
     }
 
     std::stringstream ss;
+    ss << in.rdbuf();
+    in.close();
+
+    return(ss.str());
+}
 
-    while (in.good())
+namespace
+{
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Returns the file fpath resolves to. Symlinks to existing files are followed, so replacing a file through a
+/// link keeps the link
+fs::path resolve_link(const fs::path &fpath)
+{
+    if (fs::is_symlink(fpath) && fs::exists(fpath))
     {
-        char c;
-        in.get(c);
-        ss << c;
+        return fs::canonical(fpath);
     }
-    in.close();
+    return fpath;
+}
+} // namespace
 
-    return(ss.str());
+fs::path get_replacement_path(const fs::path &fpath)
+{
+    fs::path tmp_path = resolve_link(fpath);
+    tmp_path += ".vrtlmod-tmp";
+    return tmp_path;
+}
+
+void replace_file(const fs::path &tmp_path, const fs::path &fpath)
+{
+    fs::path target = resolve_link(fpath);
+    if (fs::exists(target))
+    {
+        fs::permissions(tmp_path, fs::status(target).permissions());
+    }
+    fs::rename(tmp_path, target);
 }
 
 void string2file(const fs::path &fpath, std::string const& data)
 {
-    std::ofstream out(fpath.c_str());
+    // write to a temporary next to the target and move it in place, so concurrent readers never see a partial file
+    fs::path tmp_path = get_replacement_path(fpath);
+    std::ofstream out(tmp_path.c_str());
     if (!out.is_open())
     {
         LOG_FATAL("string2file(): Could not create file at [", fpath.c_str(), "]");
@@ -79,6 +108,25 @@ void string2file(const fs::path &fpath, std::string const& data)
     out << data;
     out.flush();
     out.close();
+    replace_file(tmp_path, fpath);
+}
+
+uint64_t hash(const std::string &data)
+{
+    uint64_t ret = 14695981039346656037ull;
+    for (unsigned char c : data)
+    {
+        ret ^= c;
+        ret *= 1099511628211ull;
+    }
+    return ret;
+}
+
+std::string hash_str(const std::string &data)
+{
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash(data)));
+    return buf;
 }
 
 namespace strhelp
@@ -21,6 +21,8 @@
 #include "vrtlmod/util/utility.hpp"
 #include "vrtlmod/util/logging.hpp"
 
+#include <algorithm>
+#include <map>
 #include <string>
 #include <sstream>
 #include <fstream>
@@ -37,6 +39,60 @@ namespace vapi
 
 VapiGenerator::VapiGenerator(VrtlmodCore &vrtlmod_core) : core_(vrtlmod_core) {}
 
+const std::vector<VapiGenerator::TargetInstance> &VapiGenerator::get_target_instances(void) const
+{
+    if (target_instances_valid_)
+    {
+        return target_instances_;
+    }
+    const VrtlmodCore &core = get_core();
+
+    std::map<std::string, const types::Cell *> module_cells; // module id -> first cell, the top cell comes first
+    core.foreach_cell([&](const types::Cell &c) -> bool {
+        module_cells.emplace(c.get_type(), &c);
+        return true;
+    });
+
+    std::map<const types::Module *, std::vector<const types::Target *>> module_targets;
+    core.foreach_injection_target([&](const types::Target &t) -> bool {
+        module_targets[&t.get_parent()].push_back(&t);
+        return true;
+    });
+
+    std::vector<const types::Module *> modules;
+    core.foreach_module([&](const types::Module &m) -> bool {
+        modules.push_back(&m);
+        return true;
+    });
+    auto by_id = [](const auto *a, const auto *b) -> bool { return a->get_id() < b->get_id(); };
+    std::sort(modules.begin(), modules.end(), by_id);
+
+    target_instances_.clear();
+    for (auto const *m : modules)
+    {
+        auto cell_iter = module_cells.find(m->get_id());
+        if (cell_iter == module_cells.end())
+        {
+            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
+        }
+        const types::Cell *c = cell_iter->second;
+
+        auto &targets = module_targets[m];
+        std::sort(targets.begin(), targets.end(), by_id);
+        for (auto const *t : targets)
+        {
+            for (const auto &module_instance : t->get_parent().symboltable_instances_)
+            {
+                std::string prefix_str = core.get_prefix(c, module_instance);
+                std::string member_str = core.get_memberstr(c, *t, prefix_str);
+                target_instances_.push_back({ c, prefix_str, member_str, t });
+            }
+        }
+    }
+    target_instances_valid_ = true;
+    return target_instances_;
+}
+
 std::string VapiGenerator::get_targetdictionary_relpath(void) const
 {
     std::string ret = API_TD_DIRPREFIX != "" ? std::string(API_TD_DIRPREFIX) + "/" : "";
@@ -36,6 +36,24 @@
 #define __LIKELY(x) __builtin_expect(!!(x), 1)
 #define __UNLIKELY(x) __builtin_expect(!!(x), 0)
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Switch around every injection statement vrtlmod writes into the VRTL. It tests the number of armed entries
+/// of the model, which vrtlmod adds to the symbol table (<top>__Syms::vrtlmod_armed_count_) and which is reached
+/// through vlSymsp, in scope in every Verilated function. So cycles without any armed target do not touch the target
+/// dictionary at all. Each statement then tests the armed flag of its target instance, which lives in the compact
+/// armed array of the API (see TD_API::armed_), through the target's <target>__armed_ member, so with an armed target
+/// only the one entry to inject is dereferenced. The switch is per model: a golden reference model is just another
+/// instance of the same classes, connected to an API without armed targets or to none, and is not affected by targets
+/// armed elsewhere.
+#define VRTLMOD_INJECT(...)                                                                                            \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (__UNLIKELY(vlSymsp->vrtlmod_armed_count_ != 0))                                                            \
+        {                                                                                                              \
+            __VA_ARGS__;                                                                                               \
+        }                                                                                                              \
+    } while (0)
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief namespace for all vrtlfi
 namespace vrtlfi
@@ -54,6 +72,68 @@ typedef enum INJ_TYPE
 namespace td
 {
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Armed flag of targets in VRTL instances that are not connected to an API, i.e., always false. Default of the
+/// <target>__armed_ members in the VRTL
+inline const bool *never_armed(void)
+{
+    static const bool never = false; // constant initialized, no guard
+    return &never;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class ArmedFlag
+/// @brief Enable flag of a target dictionary entry, used like a bool. Its storage can be moved into a slot of a
+/// compact armed array (see TD_API::armed_), and while bound it keeps the armed entry count of the model up to date
+/// (<top>__Syms::vrtlmod_armed_count_), both of which the injection statements in the VRTL test
+class ArmedFlag
+{
+    bool *flag_;      ///< Storage of the flag, own_ or a slot of an armed array
+    unsigned *count_; ///< Armed entry count the flag is counted in, nullptr if unbound
+    bool own_;        ///< Storage of the flag while it is not bound to an armed array
+
+  public:
+    operator bool(void) const { return *flag_; }
+    ArmedFlag &operator=(bool armed)
+    {
+        if (*flag_ != armed)
+        {
+            *flag_ = armed;
+            if (count_ != nullptr)
+            {
+                armed ? ++*count_ : --*count_;
+            }
+        }
+        return *this;
+    }
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    /// \brief Move the flag into an external slot, e.g., of a compact armed array (see TD_API::bind_armed())
+    /// \param slot new storage of the flag, has to outlive the binding. nullptr moves the flag back into itself
+    /// \param count armed entry count the flag is counted in from now on
+    void bind(bool *slot, unsigned *count)
+    {
+        if (slot == nullptr)
+        {
+            slot = &own_;
+        }
+        *slot = *flag_;
+        flag_ = slot;
+        if (*flag_)
+        {
+            if (count_ != nullptr)
+            {
+                --*count_;
+            }
+            ++*count;
+        }
+        count_ = count;
+    }
+
+    explicit ArmedFlag(bool armed = false) : flag_(&own_), count_(nullptr), own_(armed) {}
+    ArmedFlag(const ArmedFlag &) = delete;
+    ArmedFlag &operator=(const ArmedFlag &) = delete;
+};
+
 // FORWARDS ////////////////////////////////////////////////////////////////////////////////////////
 template <typename>
 class Named_TDentry;
@@ -78,7 +158,7 @@ class TDentry
   public:
     const bool injectable_;     ///< This entry is injectable, if not it may be used for addressing
                                 ///<  or logging only.
-    bool enable_;               ///< Entry is enabled to perform injections
+    ArmedFlag enable_;          ///< Entry is enabled to perform injections
     INJ_TYPE_t inj_type_;       ///< Type of injection to perform
     const unsigned bits_;       ///< Number of bits within target
     const unsigned onedimbits_; ///< Number of bits of one-dimensional element (e.g. only 65 bits of a target
@@ -396,6 +476,26 @@ class TD_API
     ////////////////////////////////////////////////////////////////////////////////////////////////
     /// \brief List of TDentry dictionary entries
     std::map<std::string, TDentry*> td_{};
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    /// \brief Enable flags of all entries, indexed by target id. The injection statements in the VRTL test these
+    /// through their <target>__armed_ members, i.e., one compact array instead of one cold entry per target
+    std::unique_ptr<bool[]> armed_{};
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    /// \brief Move the enable flags of all entries into a new armed_ array. Entries without an id keep their flag
+    /// themselves. The <target>__armed_ members of the VRTL have to be reconnected afterwards
+    /// \param target2id target id of each entry, ids have to be in [0, target2id.size())
+    /// \param armed_count armed entry count of the model the entries target (<top>__Syms::vrtlmod_armed_count_)
+    void bind_armed(const std::map<const TDentry *, size_t> &target2id, unsigned *armed_count)
+    {
+        std::unique_ptr<bool[]> armed(new bool[target2id.size()]{});
+        for (auto const &it : td_)
+        {
+            auto id = target2id.find(it.second);
+            it.second->enable_.bind(id != target2id.end() ? &armed[id->second] : nullptr, armed_count);
+        }
+        armed_.swap(armed); // frees the previous array only after all flags moved out of it
+    }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     /// \brief Prepare an injection: Set bits accordingly and arm target
@@ -57,68 +57,106 @@ std::string VapiGenerator::VapiTargetDictionaryPythonModule::generate_body(void)
     // TODO: implement this python module
     bool first = true;
 
-    x << R"(class TD:
+    x << R"(import mmap
+import struct
+
+
+class AnalysisDB:
+    """
+    Read-only loader of the binary analysis database <top>-vrtlmod.db written next to the analysis XML.
+    The layout is documented in include/vrtlmod/core/analysisdb.hpp of vrtlmod. Records are returned as tuples in
+    the field order of their C++ struct, nested locations are flattened to (<file>, <line>, <column>).
+    """
+    MAGIC = b'VRTLMDB\0'
+    VERSION = 1
+    NONE = 0xffffffff
+    STRINGS, FILES, MODULES, CELLS, VARIABLES, DIMENSIONS, LOCATIONS = range(7)
+    RECORDS_ = {
+        FILES: struct.Struct('<2I'),
+        MODULES: struct.Struct('<8I'),
+        CELLS: struct.Struct('<7I'),
+        VARIABLES: struct.Struct('<3Ii9I'),
+        DIMENSIONS: struct.Struct('<2i'),
+        LOCATIONS: struct.Struct('<3I'),
+    }
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data_ = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        header = struct.unpack_from('<8s16I', self.data_, 0)
+        if header[0] != self.MAGIC or header[1] != self.VERSION:
+            raise ValueError(path + " is no vrtlmod analysis database of version " + str(self.VERSION))
+        self.top_cell_ = header[2]
+        self.sections_ = [ (header[3 + 2 * s], header[4 + 2 * s]) for s in range(7) ]
+
+    def count(self, section):
+        """
+        Number of records of a section (bytes for STRINGS)
+        """
+        return self.sections_[section][1]
+
+    def record(self, section, index):
+        """
+        Get the record at index of a section
+        """
+        offset, count = self.sections_[section]
+        if index >= count:
+            raise IndexError(index)
+        rec = self.RECORDS_[section]
+        return rec.unpack_from(self.data_, offset + index * rec.size)
+
+    def records(self, section):
+        """
+        Iterate over all records of a section
+        """
+        offset, count = self.sections_[section]
+        return self.RECORDS_[section].iter_unpack(self.data_[offset:offset + count * self.RECORDS_[section].size])
+
+    def string(self, ref):
+        """
+        Get a string by its reference into the STRINGS section
+        """
+        offset, size = self.sections_[self.STRINGS]
+        end = self.data_.find(b'\0', offset + ref, offset + size)
+        return self.data_[offset + ref:end].decode()
+
+
+class TD:
     """
     Trackable targets, use data_ as: <id>: (<name>, <nmb_bits>, <injectable>)
     """
     data_ = {
           )";
 
-    auto write_data_set = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
-
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
+    auto write_data_set = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
 
-        if (c == nullptr)
+        std::string initializer_str = util::concat(
+            // clang-format off
+              "( "
+            , util::concat("\"", prefix_str, ".", t.get_id(), "\"")
+            , ", "
+            , std::to_string(t.get_bits())
+            , ", "
+            , "True"
+            , " )"
+            // clang-format on
+        );
+        if (!first)
         {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
-        }
-
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    auto prefix_str = core.get_prefix(c, module_instance);
-
-                    std::string initializer_str = util::concat(
-                        // clang-format off
-                          "( "
-                        , util::concat("\"", prefix_str, ".", t.get_id(), "\"")
-                        , ", "
-                        , std::to_string(t.get_bits())
-                        , ", "
-                        , "True"
-                        , " )"
-                        // clang-format on
-                    );
-                    if (!first)
-                    {
-                        x << R"(
+            x << R"(
         , )";
-                    }
-                    x << td_nmb++ << ": " << initializer_str;
-                    first = false;
-                }
-            }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-
-        return true;
+        }
+        x << td_nmb++ << ": " << initializer_str;
+        first = false;
     };
 
     td_nmb = 0;
-    core.foreach_module(write_data_set);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        write_data_set(inst);
+    }
 
     if (core.is_systemc())
     {
@@ -75,207 +75,179 @@ std::string VapiGenerator::VapiDiffCompareSource::generate_body(void) const
 )";
     bool hard_unroll = bool(DiffApiHardUnroll); // if false we de-serialize the element index for multi-dimensional accesses
 
-    auto writediffbody = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
+    auto writediffbody = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+        const std::string &member_str = inst.memberstr_;
+        size_t element_idx = 0;
 
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
-
-        if (c == nullptr)
-        {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
-        }
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    size_t element_idx = 0;
-                    auto prefix_str = core.get_prefix(c, module_instance);
-                    auto member_str = core.get_memberstr(c, t, prefix_str);
+        const auto &cxxdim = t.get_cxx_dimension_lengths();
 
-                    auto cxxdim = t.get_cxx_dimension_lengths();
+        auto lhs_str = "faulty_.vrtl_." + member_str;
+        auto rhs_str = "reference_.vrtl_." + member_str;
+        auto xor_str = "this->vrtl_." + member_str;
 
-                    auto lhs_str = "faulty_.vrtl_." + member_str;
-                    auto rhs_str = "reference_.vrtl_." + member_str;
-                    auto xor_str = "this->vrtl_." + member_str;
-
-                    x << R"(
+        x << R"(
         case )" << td_nmb
-                      << ": ";
-                    x << "// " << prefix_str << "." << t.get_id() << ":";
+          << ": ";
+        x << "// " << prefix_str << "." << t.get_id() << ":";
 
-                    switch (cxxdim.size())
-                    {
-                    case 0:
-                    {
-                        x << R"(
+        switch (cxxdim.size())
+        {
+        case 0:
+        {
+            x << R"(
         {
             (void)(element_idx) /* unused */;
             auto d = ()" << xor_str
-                          << " ^ "
-                          << "val"
-                          << ") & 0x" << std::hex << t.get_element_mask({}) << std::dec << ";";
-                        x << R"(
+              << " ^ "
+              << "val"
+              << ") & 0x" << std::hex << t.get_element_mask({}) << std::dec << ";";
+            x << R"(
             return d == 0 ? true : false;
         })";
-                    }
-                    break;
-                    case 1:
-                    {
-                        x << R"(
+        }
+        break;
+        case 1:
+        {
+            x << R"(
         {)";
-                        if (hard_unroll)
-                        {
-                            x << R"(
+            if (hard_unroll)
+            {
+                x << R"(
             switch (element_idx)
             {)";
-                            for (size_t k = 0; k < cxxdim[0]; ++k)
-                            {
-                                x << R"(
+                for (size_t k = 0; k < cxxdim[0]; ++k)
+                {
+                    x << R"(
                 case )" << element_idx
-                                  << ":"
-                                  << R"(
+                      << ":"
+                      << R"(
                 {
                     auto d = ()" << xor_str
-                                  << "[" << k << "]"
-                                  << " ^ "
-                                  << "val"
-                                  << ") & 0x" << std::hex << t.get_element_mask({ k }) << std::dec << ";";
-                                x << R"(
+                      << "[" << k << "]"
+                      << " ^ "
+                      << "val"
+                      << ") & 0x" << std::hex << t.get_element_mask({ k }) << std::dec << ";";
+                    x << R"(
                     return d == 0 ? true : false;
                 })";
-                                ++element_idx;
-                            }
-                            x << R"(
+                    ++element_idx;
+                }
+                x << R"(
             })";
-                        }
-                        else
-                        {
-                            x << R"(
+            }
+            else
+            {
+                x << R"(
             size_t k = element_idx;
             return ((val ^ )" << xor_str
-                              << "[k]) == 0) ? true : false;";
-                        }
-                        x << R"(
+                  << "[k]) == 0) ? true : false;";
+            }
+            x << R"(
         })";
-                    }
-                    break;
-                    case 2:
-                    {
-                        x << R"(
+        }
+        break;
+        case 2:
+        {
+            x << R"(
         {)";
-                        if (hard_unroll)
-                        {
-                            x << R"(
+            if (hard_unroll)
+            {
+                x << R"(
             switch (element_idx)
             {)";
-                            for (size_t l = 0; l < cxxdim[0]; ++l)
-                                for (size_t k = 0; k < cxxdim[1]; ++k)
-                                {
-                                    x << R"(
+                for (size_t l = 0; l < cxxdim[0]; ++l)
+                    for (size_t k = 0; k < cxxdim[1]; ++k)
+                    {
+                        x << R"(
                 case )" << element_idx << ":"
-                                      << R"(
+                          << R"(
                 {
                     auto d = ()" << xor_str
-                                      << "[" << l << "]"
-                                      << "[" << k << "]"
-                                      << " ^ "
-                                      << "val"
-                                      << ") & 0x" << std::hex << t.get_element_mask({ l, k }) << std::dec << ";";
-                                    x << R"(
+                          << "[" << l << "]"
+                          << "[" << k << "]"
+                          << " ^ "
+                          << "val"
+                          << ") & 0x" << std::hex << t.get_element_mask({ l, k }) << std::dec << ";";
+                        x << R"(
                     return d == 0 ? true : false;
                 })";
-                                    ++element_idx;
-                                }
-                            x << R"(
+                        ++element_idx;
+                    }
+                x << R"(
             })";
-                        }
-                        else
-                        {
-                            x << R"(
+            }
+            else
+            {
+                x << R"(
             size_t l = element_idx / )"
-                              << cxxdim[1] << R"(/*K*/;
+                  << cxxdim[1] << R"(/*K*/;
             size_t k = element_idx % )"
-                              << cxxdim[1] << R"(/*K*/;
+                  << cxxdim[1] << R"(/*K*/;
             return ((val ^ )" << xor_str
-                              << "[l][k]) == 0) ? true : false;";
-                        }
-                        x << R"(
+                  << "[l][k]) == 0) ? true : false;";
+            }
+            x << R"(
         })";
-                    }
-                    break;
-                    case 3:
-                    {
-                        x << R"(
+        }
+        break;
+        case 3:
+        {
+            x << R"(
         {)";
-                        if (hard_unroll)
-                        {
-                            x << R"(
+            if (hard_unroll)
+            {
+                x << R"(
             switch (element_idx)
             {)";
-                            for (size_t m = 0; m < cxxdim[0]; ++m)
-                                for (size_t l = 0; l < cxxdim[1]; ++l)
-                                    for (size_t k = 0; k < cxxdim[2]; ++k)
-                                    {
-                                        x << R"(
+                for (size_t m = 0; m < cxxdim[0]; ++m)
+                    for (size_t l = 0; l < cxxdim[1]; ++l)
+                        for (size_t k = 0; k < cxxdim[2]; ++k)
+                        {
+                            x << R"(
                 case )" << element_idx << ":"
-                                          << R"(
+                              << R"(
                 {
                     auto d = ()" << xor_str
-                                          << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << " ^ "
-                                          << "val"
-                                          << ") & 0x" << std::hex << t.get_element_mask({ m, l, k }) << std::dec << ";";
-                                        x << R"(
+                              << "[" << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << " ^ "
+                              << "val"
+                              << ") & 0x" << std::hex << t.get_element_mask({ m, l, k }) << std::dec << ";";
+                            x << R"(
                     return d == 0 ? true : false;
                 })";
-                                        ++element_idx;
-                                    }
-                            x << R"(
-            })";
+                            ++element_idx;
                         }
-                        else
-                        {
-                            x << R"(
+                x << R"(
+            })";
+            }
+            else
+            {
+                x << R"(
             size_t m = (element_idx / )"
-                              << cxxdim[2] << "/*K*/) / " << cxxdim[1] << "/*L*/;"
-                              << R"(
+                  << cxxdim[2] << "/*K*/) / " << cxxdim[1] << "/*L*/;"
+                  << R"(
             size_t l = (element_idx / )"
-                              << cxxdim[2] << "/*K*/) % " << cxxdim[1] << "/*L*/;"
-                              << R"(
+                  << cxxdim[2] << "/*K*/) % " << cxxdim[1] << "/*L*/;"
+                  << R"(
             size_t k = element_idx % )"
-                              << cxxdim[2] << "/*K*/;"
-                              << R"(
+                  << cxxdim[2] << "/*K*/;"
+                  << R"(
             return ((val ^ )" << xor_str
-                              << "[m][l][k]) == 0) ? true : false;";
-                        }
-                        x << R"(
-        })";
-                    }
-                    break;
-                    default:
-                        LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
-                        break;
-                    }
-                    ++td_nmb;
-                }
+                  << "[m][l][k]) == 0) ? true : false;";
             }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-
-        return true;
+            x << R"(
+        })";
+        }
+        break;
+        default:
+            LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
+            break;
+        }
+        ++td_nmb;
     };
 
     x << R"(
@@ -291,7 +263,10 @@ std::string VapiGenerator::VapiDiffCompareSource::generate_body(void) const
     {)";
 
     fast_compare = false;
-    core.foreach_module(writediffbody);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        writediffbody(inst);
+    }
 
     if (core.is_systemc())
     {
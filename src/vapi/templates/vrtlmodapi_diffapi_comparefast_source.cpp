@@ -74,193 +74,165 @@ std::string VapiGenerator::VapiDiffCompareFastSource::generate_body(void) const
 )";
     bool hard_unroll = bool(DiffApiHardUnroll);
 
-    auto writecomparebody_for_module = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
+    auto writecomparebody_for_module = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+        const std::string &member_str = inst.memberstr_;
 
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
-
-        if (c == nullptr)
-        {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
-        }
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    auto prefix_str = core.get_prefix(c, module_instance);
-                    auto member_str = core.get_memberstr(c, t, prefix_str);
-
-                    auto cxxdim = t.get_cxx_dimension_lengths();
+        const auto &cxxdim = t.get_cxx_dimension_lengths();
 
-                    auto lhs_str = "faulty_.vrtl_." + member_str;
-                    auto rhs_str = "reference_.vrtl_." + member_str;
-                    auto xor_str = "this->vrtl_." + member_str;
+        auto lhs_str = "faulty_.vrtl_." + member_str;
+        auto rhs_str = "reference_.vrtl_." + member_str;
+        auto xor_str = "this->vrtl_." + member_str;
 
-                    x << R"(
+        x << R"(
         case )" << td_nmb
-                      << ": ";
-                    x << "// " << prefix_str << "." << t.get_id() << ":";
+          << ": ";
+        x << "// " << prefix_str << "." << t.get_id() << ":";
 
-                    switch (cxxdim.size())
-                    {
-                    case 0:
-                    {
-                        if (hard_unroll)
-                        {
-                            x << R"(
+        switch (cxxdim.size())
+        {
+        case 0:
+        {
+            if (hard_unroll)
+            {
+                x << R"(
             if(__UNLIKELY(()" << lhs_str
-                              << " ^ " << rhs_str << ") & 0x" << std::hex << t.get_element_mask({}) << std::dec << "))"
-                              << R"(
+                  << " ^ " << rhs_str << ") & 0x" << std::hex << t.get_element_mask({}) << std::dec << "))"
+                  << R"(
                 return faulty_.td_.at)"
-                              << "(\"" << prefix_str << "." << t.get_id() << "\").get();";
-                        }
-                        else
-                        {
-                            x << R"(
+                  << "(\"" << prefix_str << "." << t.get_id() << "\").get();";
+            }
+            else
+            {
+                x << R"(
             if(__UNLIKELY()" << lhs_str
-                              << " ^ " << rhs_str << "))"
-                              << R"(
+                  << " ^ " << rhs_str << "))"
+                  << R"(
                 return )" << lhs_str
-                              << "__td_;";
-                        }
-                    }
-                    break;
-                    case 1:
-                    {
-                        if (hard_unroll)
-                        {
-                            for (size_t m = 0; m < cxxdim[0]; ++m)
-                            {
+                  << "__td_;";
+            }
+        }
+        break;
+        case 1:
+        {
+            if (hard_unroll)
+            {
+                for (size_t m = 0; m < cxxdim[0]; ++m)
+                {
 
-                                x << R"(
+                    x << R"(
             if(__UNLIKELY(()" << lhs_str
-                                  << "[" << m << "]"
-                                  << " ^ " << rhs_str << "[" << m << "]) & 0x" << std::hex << t.get_element_mask({ m })
-                                  << std::dec << "))"
-                                  << R"(
+                      << "[" << m << "]"
+                      << " ^ " << rhs_str << "[" << m << "]) & 0x" << std::hex << t.get_element_mask({ m })
+                      << std::dec << "))"
+                      << R"(
                 return faulty_.td_.at)"
-                                  << "(\"" << prefix_str << "." << t.get_id() << "\").get();";
-                            }
-                        }
-                        else // stick with loops.
-                        {
-                            x << R"(
+                      << "(\"" << prefix_str << "." << t.get_id() << "\").get();";
+                }
+            }
+            else // stick with loops.
+            {
+                x << R"(
             for(size_t m = 0; m < )"
-                              << cxxdim[0] << R"(; ++m)
+                  << cxxdim[0] << R"(; ++m)
                 if(__UNLIKELY()"
-                              << lhs_str << "[m]"
-                              << " ^ " << rhs_str << "[m]"
-                              << "))"
-                              << R"(
+                  << lhs_str << "[m]"
+                  << " ^ " << rhs_str << "[m]"
+                  << "))"
+                  << R"(
                     return )" << lhs_str
-                              << "__td_;";
-                        }
-                    }
-                    break;
-                    case 2:
+                  << "__td_;";
+            }
+        }
+        break;
+        case 2:
+        {
+            if (hard_unroll)
+            {
+                for (size_t l = 0; l < cxxdim[1]; ++l)
+                    for (size_t m = 0; m < cxxdim[0]; ++m)
                     {
-                        if (hard_unroll)
-                        {
-                            for (size_t l = 0; l < cxxdim[1]; ++l)
-                                for (size_t m = 0; m < cxxdim[0]; ++m)
-                                {
 
-                                    x << R"(
+                        x << R"(
             if(__UNLIKELY(()" << lhs_str
-                                      << "[" << m << "]"
-                                      << "[" << l << "]"
-                                      << " ^ " << rhs_str << "[" << m << "]"
-                                      << "[" << l << "]) & 0x" << std::hex << t.get_element_mask({ m, l }) << std::dec
-                                      << " ))"
-                                      << R"(
+                          << "[" << m << "]"
+                          << "[" << l << "]"
+                          << " ^ " << rhs_str << "[" << m << "]"
+                          << "[" << l << "]) & 0x" << std::hex << t.get_element_mask({ m, l }) << std::dec
+                          << " ))"
+                          << R"(
                 return faulty_.td_.at)"
-                                      << "(\"" << prefix_str << "." << t.get_id() << "\").get();";
-                                }
-                        }
-                        else
-                        {
-                            x << R"(
+                          << "(\"" << prefix_str << "." << t.get_id() << "\").get();";
+                    }
+            }
+            else
+            {
+                x << R"(
             for(size_t m = 0; m < )"
-                              << cxxdim[0] << R"(; ++m)
+                  << cxxdim[0] << R"(; ++m)
                 for(size_t l = 0; l < )"
-                              << cxxdim[1] << R"(; ++l)
+                  << cxxdim[1] << R"(; ++l)
                     if(__UNLIKELY()"
-                              << lhs_str << "[m][l]"
-                              << " ^ " << rhs_str << "[m][l]"
-                              << "))"
-                              << R"(
+                  << lhs_str << "[m][l]"
+                  << " ^ " << rhs_str << "[m][l]"
+                  << "))"
+                  << R"(
                         return )"
-                              << lhs_str << "__td_;";
-                        }
-                    }
-                    break;
-                    case 3:
-                    {
-                        if (hard_unroll)
+                  << lhs_str << "__td_;";
+            }
+        }
+        break;
+        case 3:
+        {
+            if (hard_unroll)
+            {
+                for (size_t k = 0; k < cxxdim[2]; ++k)
+                    for (size_t l = 0; l < cxxdim[1]; ++l)
+                        for (size_t m = 0; m < cxxdim[0]; ++m)
                         {
-                            for (size_t k = 0; k < cxxdim[2]; ++k)
-                                for (size_t l = 0; l < cxxdim[1]; ++l)
-                                    for (size_t m = 0; m < cxxdim[0]; ++m)
-                                    {
-                                        x << R"(
+                            x << R"(
             if(__UNLIKELY(()" << lhs_str << "["
-                                          << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << " ^ " << rhs_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]) & 0x" << std::hex << t.get_element_mask({ m, l, k })
-                                          << std::dec << "))"
-                                          << R"(
+                              << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << " ^ " << rhs_str << "[" << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]) & 0x" << std::hex << t.get_element_mask({ m, l, k })
+                              << std::dec << "))"
+                              << R"(
                 return faulty_.td_.at)"
-                                          << "(\"" << prefix_str << "." << t.get_id() << "\").get();";
-                                    }
+                              << "(\"" << prefix_str << "." << t.get_id() << "\").get();";
                         }
-                        else
-                        {
-                            x << R"(
+            }
+            else
+            {
+                x << R"(
             for(size_t m = 0; m < )"
-                              << cxxdim[0] << R"(; ++m)
+                  << cxxdim[0] << R"(; ++m)
                 for(size_t l = 0; l < )"
-                              << cxxdim[1] << R"(; ++l)
+                  << cxxdim[1] << R"(; ++l)
                     for(size_t k = 0; k < )"
-                              << cxxdim[2] << R"(; ++k)
+                  << cxxdim[2] << R"(; ++k)
                         if(__UNLIKELY()"
-                              << lhs_str << "[m][l][k]"
-                              << " ^ " << rhs_str << "[m][l][k]"
-                              << "))"
-                              << R"(
+                  << lhs_str << "[m][l][k]"
+                  << " ^ " << rhs_str << "[m][l][k]"
+                  << "))"
+                  << R"(
                             return )"
-                              << lhs_str << "__td_;";
-                        }
-                    }
-                    break;
-                    default:
-                        LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
-                        break;
-                    }
-                    x << R"(
-        [[ fallthrough ]];)";
-
-                    x << std::endl;
-                    ++td_nmb;
-                }
+                  << lhs_str << "__td_;";
             }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
+        }
+        break;
+        default:
+            LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
+            break;
+        }
+        x << R"(
+        [[ fallthrough ]];)";
 
-        return true;
+        x << std::endl;
+        ++td_nmb;
     };
 
     x << R"(
@@ -277,7 +249,10 @@ compare_rotate_switch_entry:
     {
 )";
     td_nmb = 0;
-    core.foreach_module(writecomparebody_for_module);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        writecomparebody_for_module(inst);
+    }
 
     if (core.is_systemc())
     {
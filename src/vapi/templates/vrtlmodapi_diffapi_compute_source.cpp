@@ -76,195 +76,167 @@ std::string VapiGenerator::VapiDiffComputeSource::generate_body(void) const
         bool(DiffApiHardUnroll); // one statement for basic Ctype element XOR for complex data types a[M][L][K] -> unroll M-L-K
     bool hard_mask = false; // after XOR bit-wise AND with bit-vector to ensure Ctypes are aliased to RTL bits
 
-    auto writecomparebody = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
+    auto writecomparebody = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+        const std::string &member_str = inst.memberstr_;
 
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
-
-        if (c == nullptr)
-        {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
-        }
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    auto prefix_str = core.get_prefix(c, module_instance);
-                    auto member_str = core.get_memberstr(c, t, prefix_str);
-
-                    auto cxxdim = t.get_cxx_dimension_lengths();
+        const auto &cxxdim = t.get_cxx_dimension_lengths();
 
-                    auto lhs_str = "faulty_.vrtl_." + member_str;
-                    auto rhs_str = "reference_.vrtl_." + member_str;
-                    auto xor_str = "this->vrtl_." + member_str;
+        auto lhs_str = "faulty_.vrtl_." + member_str;
+        auto rhs_str = "reference_.vrtl_." + member_str;
+        auto xor_str = "this->vrtl_." + member_str;
 
-                    x << R"(
+        x << R"(
     )";
 
-                    x << "// " << prefix_str << "." << t.get_id() << ":";
+        x << "// " << prefix_str << "." << t.get_id() << ":";
 
-                    switch (cxxdim.size())
-                    {
-                    case 0:
-                    {
+        switch (cxxdim.size())
+        {
+        case 0:
+        {
 
-                        x << R"(
+            x << R"(
     )" << xor_str << " = ("
-                          << lhs_str << " ^ " << rhs_str << ") & 0x" << std::hex << t.get_element_mask({}) << std::dec
-                          << ";";
-                        x << R"(
+              << lhs_str << " ^ " << rhs_str << ") & 0x" << std::hex << t.get_element_mask({}) << std::dec
+              << ";";
+            x << R"(
     ret += )" << xor_str << "? 1 : 0;";
-                    }
-                    break;
-                    case 1:
-                    {
-                        if (hard_unroll)
-                        {
-                            for (size_t k = 0; k < cxxdim[0]; ++k)
-                            {
-                                x << R"(
+        }
+        break;
+        case 1:
+        {
+            if (hard_unroll)
+            {
+                for (size_t k = 0; k < cxxdim[0]; ++k)
+                {
+                    x << R"(
     )" << xor_str << "[" << k << "]"
-                                  << " = (" << lhs_str << "[" << k << "]"
-                                  << " ^ " << rhs_str << "[" << k << "])"
-                                  << " & 0x" << std::hex << t.get_element_mask({ k }) << std::dec << ";";
-                                x << R"(
+                      << " = (" << lhs_str << "[" << k << "]"
+                      << " ^ " << rhs_str << "[" << k << "])"
+                      << " & 0x" << std::hex << t.get_element_mask({ k }) << std::dec << ";";
+                    x << R"(
     ret += )" << xor_str << "[" << k
-                                  << "] ? 1 : 0;";
-                            }
-                        }
-                        else
-                        {
-                            x << R"(
+                      << "] ? 1 : 0;";
+                }
+            }
+            else
+            {
+                x << R"(
     for(size_t k = 0; k < )" << cxxdim[0]
-                              << R"(/*K*/; ++k)
+                  << R"(/*K*/; ++k)
     {
         )" << xor_str << "[k]"
-                              << " = (" << lhs_str << "[k]"
-                              << " ^ " << rhs_str << "[k]);"
-                              << R"(
+                  << " = (" << lhs_str << "[k]"
+                  << " ^ " << rhs_str << "[k]);"
+                  << R"(
         if(__UNLIKELY()" << xor_str
-                              << R"([k] != 0))
+                  << R"([k] != 0))
             ++ret;
     }
 )";
-                        }
-                    }
-                    break;
-                    case 2:
+            }
+        }
+        break;
+        case 2:
+        {
+            if (hard_unroll)
+            {
+                for (size_t l = 0; l < cxxdim[0]; ++l)
+                    for (size_t k = 0; k < cxxdim[1]; ++k)
                     {
-                        if (hard_unroll)
-                        {
-                            for (size_t l = 0; l < cxxdim[0]; ++l)
-                                for (size_t k = 0; k < cxxdim[1]; ++k)
-                                {
-                                    x << R"(
+                        x << R"(
     )" << xor_str << "[" << l << "]"
-                                      << "[" << k << "]"
-                                      << " = (" << lhs_str << "[" << l << "]"
-                                      << "[" << k << "]"
-                                      << " ^ " << rhs_str << "[" << l << "]"
-                                      << "[" << k << "]) & 0x" << std::hex << t.get_element_mask({ l, k }) << std::dec
-                                      << ";";
-                                    x << R"(
+                          << "[" << k << "]"
+                          << " = (" << lhs_str << "[" << l << "]"
+                          << "[" << k << "]"
+                          << " ^ " << rhs_str << "[" << l << "]"
+                          << "[" << k << "]) & 0x" << std::hex << t.get_element_mask({ l, k }) << std::dec
+                          << ";";
+                        x << R"(
     ret += )" << xor_str << "[" << l << "]"
-                                      << "[" << k << "] ? 1 : 0;";
-                                }
-                        }
-                        else
-                        {
-                            x << R"(
+                          << "[" << k << "] ? 1 : 0;";
+                    }
+            }
+            else
+            {
+                x << R"(
     for(size_t l = 0; l < )" << cxxdim[0]
-                              << "/*L*/; ++l)"
-                              << R"(
+                  << "/*L*/; ++l)"
+                  << R"(
         for(size_t k = 0; k < )"
-                              << cxxdim[1] << "/*K*/; ++k)"
-                              << R"(
+                  << cxxdim[1] << "/*K*/; ++k)"
+                  << R"(
         {
             )" << xor_str << "[l][k]"
-                              << " = (" << lhs_str << "[l][k]"
-                              << " ^ " << rhs_str << "[l][k]);"
-                              << R"(
+                  << " = (" << lhs_str << "[l][k]"
+                  << " ^ " << rhs_str << "[l][k]);"
+                  << R"(
             if(__UNLIKELY()" << xor_str
-                              << R"([l][k] != 0))
+                  << R"([l][k] != 0))
                 ++ret;
         }
 )";
-                        }
-                    }
-                    break;
-                    case 3:
-                    {
-                        if (hard_unroll)
+            }
+        }
+        break;
+        case 3:
+        {
+            if (hard_unroll)
+            {
+                for (size_t m = 0; m < cxxdim[0]; ++m)
+                    for (size_t l = 0; l < cxxdim[1]; ++l)
+                        for (size_t k = 0; k < cxxdim[2]; ++k)
                         {
-                            for (size_t m = 0; m < cxxdim[0]; ++m)
-                                for (size_t l = 0; l < cxxdim[1]; ++l)
-                                    for (size_t k = 0; k < cxxdim[2]; ++k)
-                                    {
-                                        x << R"(
+                            x << R"(
     )" << xor_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << " = (" << lhs_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << " ^ " << rhs_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]) & 0x" << std::hex << t.get_element_mask({ m, l, k })
-                                          << std::dec << ";";
-                                        x << R"(
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << " = (" << lhs_str << "[" << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << " ^ " << rhs_str << "[" << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]) & 0x" << std::hex << t.get_element_mask({ m, l, k })
+                              << std::dec << ";";
+                            x << R"(
     ret += )" << xor_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "] ? 1 : 0;";
-                                    }
+                              << "[" << l << "]"
+                              << "[" << k << "] ? 1 : 0;";
                         }
-                        else
-                        {
-                            x << R"(
+            }
+            else
+            {
+                x << R"(
     for(size_t m = 0; m < )" << cxxdim[0]
-                              << "/*M*/; ++m)"
-                              << R"(
+                  << "/*M*/; ++m)"
+                  << R"(
         for(size_t l = 0; l < )"
-                              << cxxdim[1] << "/*L*/; ++l)"
-                              << R"(
+                  << cxxdim[1] << "/*L*/; ++l)"
+                  << R"(
             for(size_t k = 0; k < )"
-                              << cxxdim[2] << "/*K*/; ++k)"
-                              << R"(
+                  << cxxdim[2] << "/*K*/; ++k)"
+                  << R"(
             {
                 )" << xor_str << "[m][l][k]"
-                              << " = (" << lhs_str << "[m][l][k]"
-                              << " ^ " << rhs_str << "[m][l][k]);"
-                              << R"(
+                  << " = (" << lhs_str << "[m][l][k]"
+                  << " ^ " << rhs_str << "[m][l][k]);"
+                  << R"(
                 if(__UNLIKELY()"
-                              << xor_str << R"([m][l][k] != 0))
+                  << xor_str << R"([m][l][k] != 0))
                     ++ret;
             }
 )";
-                        }
-                    }
-                    break;
-                    default:
-                        LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
-                        break;
-                    }
-                    x << std::endl;
-                    ++td_nmb;
-                }
             }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-
-        return true;
+        }
+        break;
+        default:
+            LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
+            break;
+        }
+        x << std::endl;
+        ++td_nmb;
     };
 
     x << R"(
@@ -276,7 +248,10 @@ std::string VapiGenerator::VapiDiffComputeSource::generate_body(void) const
 )";
 
     td_nmb = 0;
-    core.foreach_module(writecomparebody);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        writecomparebody(inst);
+    }
 
     if (core.is_systemc())
     {
@@ -332,272 +307,244 @@ std::string VapiGenerator::VapiDiffComputeSource::generate_body(void) const
 }
 )";
 
-    auto writecompute_diff_vector = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
+    auto writecompute_diff_vector = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+        const std::string &member_str = inst.memberstr_;
 
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
+        const auto &cxxdim = t.get_cxx_dimension_lengths();
 
-        if (c == nullptr)
-        {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
-        }
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    auto prefix_str = core.get_prefix(c, module_instance);
-                    auto member_str = core.get_memberstr(c, t, prefix_str);
-
-                    auto cxxdim = t.get_cxx_dimension_lengths();
+        auto lhs_str = "faulty_.vrtl_." + member_str;
+        auto rhs_str = "reference_.vrtl_." + member_str;
+        auto xor_str = "this->vrtl_." + member_str;
 
-                    auto lhs_str = "faulty_.vrtl_." + member_str;
-                    auto rhs_str = "reference_.vrtl_." + member_str;
-                    auto xor_str = "this->vrtl_." + member_str;
-
-                    x << R"(
+        x << R"(
     )";
 
-                    x << "// " << prefix_str << "." << t.get_id() << ":";
+        x << "// " << prefix_str << "." << t.get_id() << ":";
 
-                    switch (cxxdim.size())
-                    {
-                    case 0:
-                    {
+        switch (cxxdim.size())
+        {
+        case 0:
+        {
 
-                        x << R"(
+            x << R"(
     )" << xor_str << " = ("
-                          << lhs_str << " ^ " << rhs_str << ")";
-                        if (hard_mask)
-                        {
-                            x << " & 0x" << std::hex << t.get_element_mask({}) << std::dec << ";";
-                        }
-                        x << R"(;
+              << lhs_str << " ^ " << rhs_str << ")";
+            if (hard_mask)
+            {
+                x << " & 0x" << std::hex << t.get_element_mask({}) << std::dec << ";";
+            }
+            x << R"(;
     if(__UNLIKELY()" << xor_str
-                          << "!= 0))"
-                          << R"(
+              << "!= 0))"
+              << R"(
         diff_vec.push_back({ )"
-                          << td_nmb << ", "
-                          << "static_cast<uint16_t>(-1)"
-                          << ", static_cast<uint64_t>(" << xor_str << ")});"
-                          << R"(
+              << td_nmb << ", "
+              << "static_cast<uint16_t>(-1)"
+              << ", static_cast<uint64_t>(" << xor_str << ")});"
+              << R"(
 )";
-                    }
-                    break;
-                    case 1:
-                    {
-                        if (hard_unroll)
-                        {
-                            size_t element_ctr = 0;
-                            for (size_t k = 0; k < cxxdim[0]; ++k)
-                            {
-                                x << R"(
+        }
+        break;
+        case 1:
+        {
+            if (hard_unroll)
+            {
+                size_t element_ctr = 0;
+                for (size_t k = 0; k < cxxdim[0]; ++k)
+                {
+                    x << R"(
     )" << xor_str << "[" << k << "]"
-                                  << " = (" << lhs_str << "[" << k << "]"
-                                  << " ^ " << rhs_str << "[" << k << "])";
-                                if (hard_mask)
-                                {
-                                    x << " & 0x" << std::hex << t.get_element_mask({ k }) << std::dec;
-                                }
-                                x << R"(;
+                      << " = (" << lhs_str << "[" << k << "]"
+                      << " ^ " << rhs_str << "[" << k << "])";
+                    if (hard_mask)
+                    {
+                        x << " & 0x" << std::hex << t.get_element_mask({ k }) << std::dec;
+                    }
+                    x << R"(;
     if(__UNLIKELY()" << xor_str << "["
-                                  << k << "]"
-                                  << " != 0))"
-                                  << R"(
+                      << k << "]"
+                      << " != 0))"
+                      << R"(
         diff_vec.push_back({ )" << td_nmb
-                                  << ", " << element_ctr << ", static_cast<uint64_t>(" << xor_str << "[" << k << "]"
-                                  << ")});"
-                                  << R"(
+                      << ", " << element_ctr << ", static_cast<uint64_t>(" << xor_str << "[" << k << "]"
+                      << ")});"
+                      << R"(
 )";
-                                ++element_ctr;
-                            }
-                        }
-                        else
-                        {
-                            x << R"(
+                    ++element_ctr;
+                }
+            }
+            else
+            {
+                x << R"(
     for(size_t k = 0; k < )" << cxxdim[0]
-                              << R"(/*K*/; ++k)
+                  << R"(/*K*/; ++k)
     {
         )" << xor_str << "[k]"
-                              << " = (" << lhs_str << "[k]"
-                              << " ^ " << rhs_str << "[k]);"
-                              << R"(
+                  << " = (" << lhs_str << "[k]"
+                  << " ^ " << rhs_str << "[k]);"
+                  << R"(
         if(__UNLIKELY()" << xor_str
-                              << "[k]"
-                              << " != 0))"
-                              << R"(
+                  << "[k]"
+                  << " != 0))"
+                  << R"(
         diff_vec.push_back({ )"
-                              << td_nmb << ", "
-                              << "static_cast<uint16_t>(k)"
-                              << ", static_cast<uint64_t>(" << xor_str << "[k]"
-                              << ")});"
-                              << R"(
+                  << td_nmb << ", "
+                  << "static_cast<uint16_t>(k)"
+                  << ", static_cast<uint64_t>(" << xor_str << "[k]"
+                  << ")});"
+                  << R"(
     }
 )";
-                        }
-                    }
-                    break;
-                    case 2:
+            }
+        }
+        break;
+        case 2:
+        {
+            if (hard_unroll)
+            {
+                size_t element_ctr = 0;
+                for (size_t l = 0; l < cxxdim[0]; ++l)
+                    for (size_t k = 0; k < cxxdim[1]; ++k)
                     {
-                        if (hard_unroll)
-                        {
-                            size_t element_ctr = 0;
-                            for (size_t l = 0; l < cxxdim[0]; ++l)
-                                for (size_t k = 0; k < cxxdim[1]; ++k)
-                                {
-                                    x << R"(
+                        x << R"(
     )" << xor_str << "[" << l << "]"
-                                      << "[" << k << "]"
-                                      << " = (" << lhs_str << "[" << l << "]"
-                                      << "[" << k << "]"
-                                      << " ^ " << rhs_str << "[" << l << "]"
-                                      << "[" << k << "])";
-                                    if (hard_mask)
-                                    {
-                                        x << " & 0x" << std::hex << t.get_element_mask({ l, k }) << std::dec << ";";
-                                    }
-                                    x << R"(;
+                          << "[" << k << "]"
+                          << " = (" << lhs_str << "[" << l << "]"
+                          << "[" << k << "]"
+                          << " ^ " << rhs_str << "[" << l << "]"
+                          << "[" << k << "])";
+                        if (hard_mask)
+                        {
+                            x << " & 0x" << std::hex << t.get_element_mask({ l, k }) << std::dec << ";";
+                        }
+                        x << R"(;
     if(__UNLIKELY()" << xor_str << "[" << l
-                                      << "]"
-                                      << "[" << k << "]"
-                                      << " != 0))"
-                                      << R"(
+                          << "]"
+                          << "[" << k << "]"
+                          << " != 0))"
+                          << R"(
         diff_vec.push_back({ )" << td_nmb
-                                      << ", " << element_ctr << ", static_cast<uint64_t>(" << xor_str << "[" << l << "]"
-                                      << "[" << k << "]"
-                                      << ")});"
-                                      << R"(
+                          << ", " << element_ctr << ", static_cast<uint64_t>(" << xor_str << "[" << l << "]"
+                          << "[" << k << "]"
+                          << ")});"
+                          << R"(
 )";
-                                    ++element_ctr;
-                                }
-                        }
-                        else
-                        {
-                            x << R"(
+                        ++element_ctr;
+                    }
+            }
+            else
+            {
+                x << R"(
     for(size_t l = 0; l < )" << cxxdim[0]
-                              << "/*L*/; ++l)"
-                              << R"(
+                  << "/*L*/; ++l)"
+                  << R"(
         for(size_t k = 0; k < )"
-                              << cxxdim[1] << "/*K*/; ++k)"
-                              << R"(
+                  << cxxdim[1] << "/*K*/; ++k)"
+                  << R"(
         {
             )" << xor_str << "[l][k]"
-                              << " = (" << lhs_str << "[l][k]"
-                              << " ^ " << rhs_str << "[l][k]);"
-                              << R"(
+                  << " = (" << lhs_str << "[l][k]"
+                  << " ^ " << rhs_str << "[l][k]);"
+                  << R"(
             if(__UNLIKELY()" << xor_str
-                              << "[l][k]"
-                              << " != 0))"
-                              << R"(
+                  << "[l][k]"
+                  << " != 0))"
+                  << R"(
                 diff_vec.push_back({ )"
-                              << td_nmb << ", "
-                              << "static_cast<uint16_t>(l * (" << cxxdim[1] << "/*K*/) + k)"
-                              << ", static_cast<uint64_t>(" << xor_str << "[l][k]"
-                              << ")});"
-                              << R"(
+                  << td_nmb << ", "
+                  << "static_cast<uint16_t>(l * (" << cxxdim[1] << "/*K*/) + k)"
+                  << ", static_cast<uint64_t>(" << xor_str << "[l][k]"
+                  << ")});"
+                  << R"(
         }
 )";
-                        }
-                    }
-                    break;
-                    case 3:
-                    {
-                        if (hard_unroll)
+            }
+        }
+        break;
+        case 3:
+        {
+            if (hard_unroll)
+            {
+                size_t element_ctr = 0;
+                for (size_t m = 0; m < cxxdim[0]; ++m)
+                    for (size_t l = 0; l < cxxdim[1]; ++l)
+                        for (size_t k = 0; k < cxxdim[2]; ++k)
                         {
-                            size_t element_ctr = 0;
-                            for (size_t m = 0; m < cxxdim[0]; ++m)
-                                for (size_t l = 0; l < cxxdim[1]; ++l)
-                                    for (size_t k = 0; k < cxxdim[2]; ++k)
-                                    {
-                                        x << R"(
+                            x << R"(
     )" << xor_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << " = (" << lhs_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << " ^ " << rhs_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "])";
-                                        if (hard_mask)
-                                        {
-                                            x << " & 0x" << std::hex << t.get_element_mask({ m, l, k }) << std::dec
-                                              << ";";
-                                        }
-                                        x << R"(;
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << " = (" << lhs_str << "[" << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << " ^ " << rhs_str << "[" << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "])";
+                            if (hard_mask)
+                            {
+                                x << " & 0x" << std::hex << t.get_element_mask({ m, l, k }) << std::dec
+                                  << ";";
+                            }
+                            x << R"(;
     if(__UNLIKELY()" << xor_str << "[" << m
-                                          << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << " != 0))"
-                                          << R"(
+                              << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << " != 0))"
+                              << R"(
         diff_vec.push_back({ )" << td_nmb << ", "
-                                          << element_ctr << ", static_cast<uint64_t>(" << xor_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << ")});"
-                                          << R"(
+                              << element_ctr << ", static_cast<uint64_t>(" << xor_str << "[" << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << ")});"
+                              << R"(
 )";
-                                        ++element_ctr;
-                                    }
+                            ++element_ctr;
                         }
-                        else
-                        {
-                            x << R"(
+            }
+            else
+            {
+                x << R"(
     for(size_t m = 0; m < )" << cxxdim[0]
-                              << "/*M*/; ++m)"
-                              << R"(
+                  << "/*M*/; ++m)"
+                  << R"(
         for(size_t l = 0; l < )"
-                              << cxxdim[1] << "/*L*/; ++l)"
-                              << R"(
+                  << cxxdim[1] << "/*L*/; ++l)"
+                  << R"(
             for(size_t k = 0; k < )"
-                              << cxxdim[2] << "/*K*/; ++k)"
-                              << R"(
+                  << cxxdim[2] << "/*K*/; ++k)"
+                  << R"(
             {
                 )" << xor_str << "[m][l][k]"
-                              << " = (" << lhs_str << "[m][l][k]"
-                              << " ^ " << rhs_str << "[m][l][k]);"
-                              << R"(
+                  << " = (" << lhs_str << "[m][l][k]"
+                  << " ^ " << rhs_str << "[m][l][k]);"
+                  << R"(
                 if(__UNLIKELY()"
-                              << xor_str << "[m]"
-                              << "[l]"
-                              << "[k]"
-                              << " != 0))"
-                              << R"(
+                  << xor_str << "[m]"
+                  << "[l]"
+                  << "[k]"
+                  << " != 0))"
+                  << R"(
                     diff_vec.push_back({ )"
-                              << td_nmb << ", "
-                              << "static_cast<uint16_t>(m * (" << cxxdim[1] << "/*L*/ * " << cxxdim[2] << "/*K*/) + (l*"
-                              << cxxdim[2] << "/*K*/) + k)"
-                              << ", static_cast<uint64_t>(" << xor_str << "[m][l][k]"
-                              << ")});"
-                              << R"(
+                  << td_nmb << ", "
+                  << "static_cast<uint16_t>(m * (" << cxxdim[1] << "/*L*/ * " << cxxdim[2] << "/*K*/) + (l*"
+                  << cxxdim[2] << "/*K*/) + k)"
+                  << ", static_cast<uint64_t>(" << xor_str << "[m][l][k]"
+                  << ")});"
+                  << R"(
             }
 )";
-                        }
-                    }
-                    break;
-                    default:
-                        LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
-                        break;
-                    }
-                    x << std::endl;
-                    ++td_nmb;
-                }
             }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-
-        return true;
+        }
+        break;
+        default:
+            LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
+            break;
+        }
+        x << std::endl;
+        ++td_nmb;
     };
 
     x << R"(
@@ -609,7 +556,10 @@ std::string VapiGenerator::VapiDiffComputeSource::generate_body(void) const
 )";
 
     td_nmb = 0;
-    core.foreach_module(writecompute_diff_vector);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        writecompute_diff_vector(inst);
+    }
 
     if (core.is_systemc())
     {
@@ -136,191 +136,163 @@ size_t )"
 
     bool hard_unroll = bool(DiffApiHardUnroll);
 
-    auto write_triplet_push = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
+    auto write_triplet_push = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+        const std::string &member_str = inst.memberstr_;
+        size_t element_idx = 0;
 
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
-
-        if (c == nullptr)
-        {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
-        }
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    size_t element_idx = 0;
-                    auto prefix_str = core.get_prefix(c, module_instance);
-                    auto member_str = core.get_memberstr(c, t, prefix_str);
-
-                    auto cxxdim = t.get_cxx_dimension_lengths();
+        const auto &cxxdim = t.get_cxx_dimension_lengths();
 
-                    auto lhs_str = "faulty_.vrtl_." + member_str;
-                    auto rhs_str = "reference_.vrtl_." + member_str;
-                    auto xor_str = "this->vrtl_." + member_str;
+        auto lhs_str = "faulty_.vrtl_." + member_str;
+        auto rhs_str = "reference_.vrtl_." + member_str;
+        auto xor_str = "this->vrtl_." + member_str;
 
-                    x << R"(
+        x << R"(
     // )" << prefix_str
-                      << "." << t.get_id() << ":";
+          << "." << t.get_id() << ":";
 
-                    switch (cxxdim.size())
-                    {
-                    case 0:
-                    {
-                        x << R"(
+        switch (cxxdim.size())
+        {
+        case 0:
+        {
+            x << R"(
     if (auto d = )"
-                          << "static_cast<uint64_t>(" << xor_str << R"())
+              << "static_cast<uint64_t>(" << xor_str << R"())
     {
         nz_triplet_list.push_back({ )"
-                          << td_nmb << ", "
-                          << "static_cast<uint16_t>(-1)"
-                          << ", d });"
-                          << R"(
+              << td_nmb << ", "
+              << "static_cast<uint16_t>(-1)"
+              << ", d });"
+              << R"(
     }
 )";
-                    }
-                    break;
-                    case 1:
-                    {
-                        if (hard_unroll)
-                        {
-                            auto element_ctr = 0;
-                            for (size_t k = 0; k < cxxdim[0]; ++k)
-                            {
-                                x << R"(
+        }
+        break;
+        case 1:
+        {
+            if (hard_unroll)
+            {
+                auto element_ctr = 0;
+                for (size_t k = 0; k < cxxdim[0]; ++k)
+                {
+                    x << R"(
     if (auto d = )"
-                                  << "static_cast<uint64_t>(" << xor_str << "[" << k << "]"
-                                  << R"())
+                      << "static_cast<uint64_t>(" << xor_str << "[" << k << "]"
+                      << R"())
     {
         nz_triplet_list.push_back({ )"
-                                  << td_nmb << ", " << element_ctr << ", d });"
-                                  << R"(
+                      << td_nmb << ", " << element_ctr << ", d });"
+                      << R"(
     }
 )";
-                                ++element_ctr;
-                            }
-                        }
-                        else
-                        {
-                            x << R"(
+                    ++element_ctr;
+                }
+            }
+            else
+            {
+                x << R"(
     for(size_t k = 0; k < )" << cxxdim[0]
-                              << R"(/*K*/; ++k)
+                  << R"(/*K*/; ++k)
         if()" << xor_str << "[k] != 0)"
-                              << R"(
+                  << R"(
             nz_triplet_list.push_back({ )"
-                              << td_nmb << ", "
-                              << "static_cast<uint16_t>(k)"
-                              << ", " << util::concat("static_cast<uint64_t>(", xor_str, "[k]", ")") << R"(});
+                  << td_nmb << ", "
+                  << "static_cast<uint16_t>(k)"
+                  << ", " << util::concat("static_cast<uint64_t>(", xor_str, "[k]", ")") << R"(});
 )";
-                        }
-                    }
-                    break;
-                    case 2:
+            }
+        }
+        break;
+        case 2:
+        {
+            if (hard_unroll)
+            {
+                auto element_ctr = 0;
+                for (size_t l = 0; l < cxxdim[0]; ++l)
+                    for (size_t k = 0; k < cxxdim[1]; ++k)
                     {
-                        if (hard_unroll)
-                        {
-                            auto element_ctr = 0;
-                            for (size_t l = 0; l < cxxdim[0]; ++l)
-                                for (size_t k = 0; k < cxxdim[1]; ++k)
-                                {
-                                    x << R"(
+                        x << R"(
     if (auto d = )"
-                                      << "static_cast<uint64_t>(" << xor_str << "[" << l << "]"
-                                      << "[" << k << "]"
-                                      << R"())
+                          << "static_cast<uint64_t>(" << xor_str << "[" << l << "]"
+                          << "[" << k << "]"
+                          << R"())
     {
         nz_triplet_list.push_back({ )" << td_nmb
-                                      << ", " << element_ctr << ", d });"
-                                      << R"(
+                          << ", " << element_ctr << ", d });"
+                          << R"(
     }
 )";
-                                    ++element_ctr;
-                                }
-                        }
-                        else
-                        {
-                            x << R"(
+                        ++element_ctr;
+                    }
+            }
+            else
+            {
+                x << R"(
     for(size_t l = 0; l < )" << cxxdim[0]
-                              << R"(/*L*/; ++l)
+                  << R"(/*L*/; ++l)
         for(size_t k = 0; k < )"
-                              << cxxdim[1] << R"(/*K*/; ++k)
+                  << cxxdim[1] << R"(/*K*/; ++k)
             if()" << xor_str << "[l][k] != 0)"
-                              << R"(
+                  << R"(
                 nz_triplet_list.push_back({ )"
-                              << td_nmb << ", "
-                              << util::concat("static_cast<uint16_t>(l * ", std::to_string(cxxdim[1]), "/*K*/ + k)")
-                              << ", " << util::concat("static_cast<uint64_t>(", xor_str, "[l][k]", ")") << R"(});
+                  << td_nmb << ", "
+                  << util::concat("static_cast<uint16_t>(l * ", std::to_string(cxxdim[1]), "/*K*/ + k)")
+                  << ", " << util::concat("static_cast<uint64_t>(", xor_str, "[l][k]", ")") << R"(});
 )";
-                        }
-                    }
-                    break;
-                    case 3:
-                    {
-                        if (hard_unroll)
+            }
+        }
+        break;
+        case 3:
+        {
+            if (hard_unroll)
+            {
+                auto element_ctr = 0;
+                for (size_t m = 0; m < cxxdim[0]; ++m)
+                    for (size_t l = 0; l < cxxdim[1]; ++l)
+                        for (size_t k = 0; k < cxxdim[2]; ++k)
                         {
-                            auto element_ctr = 0;
-                            for (size_t m = 0; m < cxxdim[0]; ++m)
-                                for (size_t l = 0; l < cxxdim[1]; ++l)
-                                    for (size_t k = 0; k < cxxdim[2]; ++k)
-                                    {
-                                        x << R"(
+                            x << R"(
     if (auto d = )"
-                                          << "static_cast<uint64_t>(" << xor_str << "[" << m << "]"
-                                          << "[" << l << "]"
-                                          << "[" << k << "]"
-                                          << R"())
+                              << "static_cast<uint64_t>(" << xor_str << "[" << m << "]"
+                              << "[" << l << "]"
+                              << "[" << k << "]"
+                              << R"())
     {
         nz_triplet_list.push_back({ )" << td_nmb
-                                          << ", " << element_ctr << ", d });"
-                                          << R"(
+                              << ", " << element_ctr << ", d });"
+                              << R"(
     }
 )";
-                                        ++element_ctr;
-                                    }
+                            ++element_ctr;
                         }
-                        else
-                        {
-                            x << R"(
+            }
+            else
+            {
+                x << R"(
     for(size_t m = 0; m < )" << cxxdim[0]
-                              << R"(/*M*/; ++m)
+                  << R"(/*M*/; ++m)
         for(size_t l = 0; l < )"
-                              << cxxdim[1] << R"(/*L*/; ++l)
+                  << cxxdim[1] << R"(/*L*/; ++l)
             for(size_t k = 0; k < )"
-                              << cxxdim[2] << R"(/*K*/; ++k)
+                  << cxxdim[2] << R"(/*K*/; ++k)
                 if()" << xor_str
-                              << "[m][l][k] != 0)"
-                              << R"(
+                  << "[m][l][k] != 0)"
+                  << R"(
                     nz_triplet_list.push_back({ )"
-                              << td_nmb << ", "
-                              << util::concat("static_cast<uint16_t>((m*", std::to_string(cxxdim[1]), "/*L*/ + l) * ",
-                                              std::to_string(cxxdim[2]), "/*K*/ + k)")
-                              << ", " << util::concat("static_cast<uint64_t>(", xor_str, "[m][l][k]", ")") << R"(});
+                  << td_nmb << ", "
+                  << util::concat("static_cast<uint16_t>((m*", std::to_string(cxxdim[1]), "/*L*/ + l) * ",
+                                  std::to_string(cxxdim[2]), "/*K*/ + k)")
+                  << ", " << util::concat("static_cast<uint64_t>(", xor_str, "[m][l][k]", ")") << R"(});
 )";
-                        }
-                    }
-                    break;
-                    default:
-                        LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
-                        break;
-                    }
-                    ++td_nmb;
-                }
             }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-
-        return true;
+        }
+        break;
+        default:
+            LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
+            break;
+        }
+        ++td_nmb;
     };
 
     auto N_targets = td_nmb;
@@ -334,7 +306,10 @@ size_t )"
 )";
 
     td_nmb = 0;
-    core.foreach_module(write_triplet_push);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        write_triplet_push(inst);
+    }
 
     if (core.is_systemc())
     {
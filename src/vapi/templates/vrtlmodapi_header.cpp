@@ -76,76 +76,50 @@ struct )"
     void dump_diff_csv_vertical(std::ostream& out = std::cout) const;
     )";
 
-    auto write_td_value_members_declarations = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
-
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
-
-        if (c == nullptr)
+    auto write_td_value_members_declarations = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+        std::vector<std::string> cxxdim{};
+        for (int const &it : t.get_cxx_dimension_lengths())
         {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
+            cxxdim.push_back(std::to_string(it));
         }
-
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    auto prefix_str = core.get_prefix(c, module_instance);
-                    std::vector<std::string> cxxdim{};
-                    for (int const &it : t.get_cxx_dimension_lengths())
-                    {
-                        cxxdim.push_back(std::to_string(it));
-                    }
-                    auto cxxdimtypes = t.get_cxx_dimension_types();
-                    std::string decl_str;
-                    switch (cxxdim.size())
-                    {
-                    case 0:
-                        decl_str = util::concat("vrtlfi::td::", "ZeroD_TDentry< ", t.get_cxx_type(), ">");
-                        break;
-                    case 1:
-                        decl_str = util::concat("vrtlfi::td::", "OneD_TDentry< ", t.get_cxx_type(), ", ",
-                                                cxxdimtypes.back(), ", ", cxxdim[0], " >");
-                        break;
-                    case 2:
-                        decl_str = util::concat("vrtlfi::td::", "TwoD_TDentry< ", t.get_cxx_type(), ", ",
-                                                cxxdimtypes.back(), ", ", cxxdim[0], ", ", cxxdim[1], " >");
-                        break;
-                    case 3:
-                        decl_str =
-                            util::concat("vrtlfi::td::", "ThreeD_TDentry< ", t.get_cxx_type(), ", ", cxxdimtypes.back(),
-                                         ", ", cxxdim[0], ", ", cxxdim[1], ", ", cxxdim[2], " >");
-                        break;
-                    default:
-                        LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
-                        break;
-                    }
-                    std::string member_name = util::concat(prefix_str, "__DOT__", t.get_id(), "_");
-                    util::strhelp::replaceAll(member_name, ".", "__DOT__");
-                    util::strhelp::replaceAll(member_name, "->", "__REF__");
-                    x << decl_str << " " << member_name << R"(;
+        const auto &cxxdimtypes = t.get_cxx_dimension_types();
+        std::string decl_str;
+        switch (cxxdim.size())
+        {
+        case 0:
+            decl_str = util::concat("vrtlfi::td::", "ZeroD_TDentry< ", t.get_cxx_type(), ">");
+            break;
+        case 1:
+            decl_str = util::concat("vrtlfi::td::", "OneD_TDentry< ", t.get_cxx_type(), ", ",
+                                    cxxdimtypes.back(), ", ", cxxdim[0], " >");
+            break;
+        case 2:
+            decl_str = util::concat("vrtlfi::td::", "TwoD_TDentry< ", t.get_cxx_type(), ", ",
+                                    cxxdimtypes.back(), ", ", cxxdim[0], ", ", cxxdim[1], " >");
+            break;
+        case 3:
+            decl_str =
+                util::concat("vrtlfi::td::", "ThreeD_TDentry< ", t.get_cxx_type(), ", ", cxxdimtypes.back(),
+                             ", ", cxxdim[0], ", ", cxxdim[1], ", ", cxxdim[2], " >");
+            break;
+        default:
+            LOG_ERROR("CType dimensions of injection target not supported: ", t.get_cxx_type());
+            break;
+        }
+        std::string member_name = util::concat(prefix_str, "__DOT__", t.get_id(), "_");
+        util::strhelp::replaceAll(member_name, ".", "__DOT__");
+        util::strhelp::replaceAll(member_name, "->", "__REF__");
+        x << decl_str << " " << member_name << R"(;
     )";
-                }
-            }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-
-        return true;
     };
 
     td_nmb = 0;
-    core.foreach_module(write_td_value_members_declarations);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        write_td_value_members_declarations(inst);
+    }
 
     if (core.is_systemc())
     {
@@ -89,63 +89,37 @@ std::string VapiGenerator::VapiSource::generate_body(void) const
             , t.get_id());
     };
 
-    auto write_init_td = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
-
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
-
-        if (c == nullptr)
-        {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
-        }
-
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    auto prefix_str = core.get_prefix(c, module_instance);
-
-                    std::string initializer_str = util::concat(
-                        // clang-format off
-                          "{ "
-                        , util::concat("\"", prefix_str, ".", t.get_id(), "\"")
-                        , ", "
-                        , util::concat("vrtl_.", core.get_memberstr(c, t, prefix_str))
-                        , ", "
-                        , std::to_string(t.get_bits())
-                        , ", "
-                        , std::to_string(t.get_one_dim_bits())
-                        , " }"
-                        // clang-format on
-                    );
-
-                    std::string member_name = util::concat(prefix_str, "__DOT__", t.get_id(), "_");
-                    util::strhelp::replaceAll(member_name, ".", "__DOT__");
-                    util::strhelp::replaceAll(member_name, "->", "__REF__");
-                    x << R"(
+    auto write_init_td = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+
+        std::string initializer_str = util::concat(
+            // clang-format off
+              "{ "
+            , util::concat("\"", prefix_str, ".", t.get_id(), "\"")
+            , ", "
+            , util::concat("vrtl_.", inst.memberstr_)
+            , ", "
+            , std::to_string(t.get_bits())
+            , ", "
+            , std::to_string(t.get_one_dim_bits())
+            , " }"
+            // clang-format on
+        );
+
+        std::string member_name = util::concat(prefix_str, "__DOT__", t.get_id(), "_");
+        util::strhelp::replaceAll(member_name, ".", "__DOT__");
+        util::strhelp::replaceAll(member_name, "->", "__REF__");
+        x << R"(
     , )" << member_name
-                      << initializer_str;
-                }
-            }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-
-        return true;
+          << initializer_str;
     };
 
     td_nmb = 0;
-    core.foreach_module(write_init_td);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        write_init_td(inst);
+    }
 
     if (core.is_systemc())
     {
@@ -186,57 +160,29 @@ std::string VapiGenerator::VapiSource::generate_body(void) const
     std::string map_prefix = "";
     std::string retr_prefix = "";
     bool reverse_map = false;
-    auto writetarget2idinitializer = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
-
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
-
-        if (c == nullptr)
+    auto writetarget2idinitializer = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+        // auto member_str = util::concat("vrtl_.", inst.memberstr_);
+        // auto element_0 = member_str + "__td_";
+
+        std::string member_name = util::concat(prefix_str, "__DOT__", t.get_id(), "_");
+        util::strhelp::replaceAll(member_name, ".", "__DOT__");
+        util::strhelp::replaceAll(member_name, "->", "__REF__");
+        auto element_0 = util::concat("&", member_name);
+        auto element_1 = std::to_string(td_nmb);
+        x << "\n        ";
+        if (td_nmb == 0)
         {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
+            x << "  ";
         }
-
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    auto prefix_str = core.get_prefix(c, module_instance);
-                    // auto member_str = util::concat("vrtl_.", core.get_memberstr(c, t, prefix_str));
-                    // auto element_0 = member_str + "__td_";
-
-                    std::string member_name = util::concat(prefix_str, "__DOT__", t.get_id(), "_");
-                    util::strhelp::replaceAll(member_name, ".", "__DOT__");
-                    util::strhelp::replaceAll(member_name, "->", "__REF__");
-                    auto element_0 = util::concat("&", member_name);
-                    auto element_1 = std::to_string(td_nmb);
-                    x << "\n        ";
-                    if (td_nmb == 0)
-                    {
-                        x << "  ";
-                    }
-                    else
-                    {
-                        x << ", ";
-                    }
-                    x << "{ " << (reverse_map ? element_1 : element_0) << ", " << (reverse_map ? element_0 : element_1)
-                      << " }";
-                    ++td_nmb;
-                }
-            }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-        return true;
+        else
+        {
+            x << ", ";
+        }
+        x << "{ " << (reverse_map ? element_1 : element_0) << ", " << (reverse_map ? element_0 : element_1)
+          << " }";
+        ++td_nmb;
     };
 
     auto write_systemc_target2id = [&](void) -> void {
@@ -280,7 +226,10 @@ std::string VapiGenerator::VapiSource::generate_body(void) const
     x << R"(
     , )"
       << (reverse_map ? "id2target_{" : "target2id_{"); //(reverse_map ? "id2target_ = {" : "target2id_ = {");
-    core.foreach_module(writetarget2idinitializer);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        writetarget2idinitializer(inst);
+    }
     write_systemc_target2id();
     x << R"(
     })";
@@ -291,7 +240,10 @@ std::string VapiGenerator::VapiSource::generate_body(void) const
     x << R"(
     , )"
       << (reverse_map ? "id2target_{" : "target2id_{"); //(reverse_map ? "id2target_ = {" : "target2id_ = {");
-    core.foreach_module(writetarget2idinitializer);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        writetarget2idinitializer(inst);
+    }
     write_systemc_target2id();
     x << R"(
     })";
@@ -301,59 +253,33 @@ std::string VapiGenerator::VapiSource::generate_body(void) const
 }
 )";
 
-    auto write_connect_vrtl2api = [&](const types::Module &M) -> bool {
-        types::Module const *m = &M;
-        types::Cell const *c = nullptr;
-
-        auto celliter = [&](const types::Cell &C) -> bool {
-            if (m == core.get_module_from_cell(C))
-            {
-                c = &C;
-                return false;
-            }
-            return true;
-        };
-        core.foreach_cell(celliter);
-
-        if (c == nullptr)
-        {
-            LOG_FATAL("Can not find parent Cell of Module ", m->get_id(), " [", m->get_name(), "]");
-        }
-
-        auto targetiterf = [&](const types::Target &t) -> bool {
-            if (t.get_parent() == *m)
-            {
-                for (const auto &module_instance : t.get_parent().symboltable_instances_)
-                {
-                    auto prefix_str = core.get_prefix(c, module_instance);
-                    std::string vrtl_decl_name = util::concat("vrtl_.", core.get_memberstr(c, t, prefix_str));
-                    std::string member_name = util::concat(prefix_str, "__DOT__", t.get_id(), "_");
-                    util::strhelp::replaceAll(member_name, ".", "__DOT__");
-                    util::strhelp::replaceAll(member_name, "->", "__REF__");
-                    std::string map_key = util::concat(prefix_str, ".", t.get_id());
-                    x << R"(
+    auto write_connect_vrtl2api = [&](const VapiGenerator::TargetInstance &inst) -> void {
+        const types::Target &t = *inst.target_;
+        const std::string &prefix_str = inst.prefix_;
+        std::string vrtl_decl_name = util::concat("vrtl_.", inst.memberstr_);
+        std::string member_name = util::concat(prefix_str, "__DOT__", t.get_id(), "_");
+        util::strhelp::replaceAll(member_name, ".", "__DOT__");
+        util::strhelp::replaceAll(member_name, "->", "__REF__");
+        std::string map_key = util::concat(prefix_str, ".", t.get_id());
+        x << R"(
     )" << vrtl_decl_name
-                      << "__td_"
-                      << " = "
-                      << "&" << member_name << ";";
-                    x << R"(
+          << "__td_"
+          << " = "
+          << "&" << member_name << ";";
+        x << R"(
     )"
-                      << "td_[\"" << map_key << "\"] = "
-                      << "&" << member_name << ";";
-                }
-            }
-            return true;
-        };
-        core.foreach_injection_target(targetiterf);
-
-        return true;
+          << "td_[\"" << map_key << "\"] = "
+          << "&" << member_name << ";";
     };
 
     x << "void " << api_name << R"(::connect_vrtl2api(void)
 {
 )";
     td_nmb = 0;
-    core.foreach_module(write_connect_vrtl2api);
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        write_connect_vrtl2api(inst);
+    }
 
     if (core.is_systemc())
     {
@@ -380,6 +306,24 @@ std::string VapiGenerator::VapiSource::generate_body(void) const
         }
     }
 
+    // the model's armed count, added to its symbol table by VrtlmodCore::postprocess_headers()
+    x << R"(
+    bind_armed(target2id_, &vrtl_.)"
+#if VRTLMOD_VERILATOR_VERSION <= 4204
+      << SYMBOLTABLE_NAME
+#else // VRTLMOD_VERILATOR_VERSION <= 4228
+      << "rootp->" << SYMBOLTABLE_NAME
+#endif
+      << "->vrtlmod_armed_count_);";
+    td_nmb = 0;
+    for (auto const &inst : gen_.get_target_instances())
+    {
+        x << R"(
+    vrtl_.)" << inst.memberstr_
+          << "__armed_ = &armed_[" << td_nmb << "];";
+        ++td_nmb;
+    }
+
     x << R"(
 }
 
@@ -36,6 +36,7 @@
 #include "clang/Lex/Lexer.h"
 
 #include "vrtlmod/core/consumer.hpp"
+#include "vrtlmod/core/astcache.hpp"
 #include "vrtlmod/passes/rewritemacrosaction.hpp"
 #include "vrtlmod/passes/injectionrewrite.hpp"
 #include "vrtlmod/passes/elaborate.hpp"
@@ -55,25 +56,39 @@ const std::string &get_version(void)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief custom creator to pass a context instance to the ASTFrontendActions
+/// @brief custom creator to pass a context instance to the ParserActions, which can also run on cached translation
+///        units
 template <typename T, typename Ctx_t>
-std::unique_ptr<clang::tooling::FrontendActionFactory> newGeneratorFrontendActionFactory(Ctx_t &ctx)
+std::unique_ptr<ASTToolAction> newParserActionFactory(Ctx_t &ctx)
 {
-    class GeneratorFrontendActionFactory : public clang::tooling::FrontendActionFactory
+    class ParserActionFactory : public ASTToolAction
     {
         Ctx_t &ctx_;
 
       public:
-        GeneratorFrontendActionFactory(Ctx_t &ctx) : ctx_(ctx) {}
+        ParserActionFactory(Ctx_t &ctx) : ctx_(ctx) {}
         std::unique_ptr<clang::FrontendAction> create() override { return std::make_unique<T>(ctx_); }
+        void run_on_ast(clang::ASTUnit &unit) override { T::run_on_ast(ctx_, unit); }
     };
 
-    return std::make_unique<GeneratorFrontendActionFactory>(ctx);
+    return std::make_unique<ParserActionFactory>(ctx);
 }
 
-std::unique_ptr<clang::tooling::ToolAction> CreateMacroRewritePass(VrtlmodCore &core)
+std::unique_ptr<clang::tooling::ToolAction> CreateMacroRewritePass(VrtlmodCore &core, bool streaming)
 {
-    return clang::tooling::newFrontendActionFactory<vrtlmod::transform::rewrite::RewriteMacrosAction>();
+    class MacroRewriteFactory : public clang::tooling::FrontendActionFactory
+    {
+        bool streaming_;
+
+      public:
+        MacroRewriteFactory(bool streaming) : streaming_(streaming) {}
+        std::unique_ptr<clang::FrontendAction> create() override
+        {
+            return std::make_unique<vrtlmod::transform::rewrite::RewriteMacrosAction>(streaming_);
+        }
+    };
+
+    return std::make_unique<MacroRewriteFactory>(streaming);
 }
 
 std::unique_ptr<clang::tooling::ToolAction> CreateCommentRewritePass(VrtlmodCore &core)
@@ -81,24 +96,30 @@ std::unique_ptr<clang::tooling::ToolAction> CreateCommentRewritePass(VrtlmodCore
     return clang::tooling::newFrontendActionFactory<vrtlmod::transform::rewrite::RewriteCommentsAction>();
 }
 
-std::unique_ptr<clang::tooling::ToolAction> CreateElaboratePass(VrtlmodCore &core)
+std::unique_ptr<ASTToolAction> CreateElaboratePass(VrtlmodCore &core)
+{
+    return newParserActionFactory<vrtlmod::ParserAction<vrtlmod::passes::ElaboratePass>>(core);
+}
+
+std::unique_ptr<ASTToolAction> CreateAnalyzePass(VrtlmodCore &core)
 {
-    return newGeneratorFrontendActionFactory<vrtlmod::ParserAction<vrtlmod::passes::ElaboratePass>>(core);
+    return newParserActionFactory<vrtlmod::ParserAction<vrtlmod::passes::AnalyzePass>>(core);
 }
 
-std::unique_ptr<clang::tooling::ToolAction> CreateAnalyzePass(VrtlmodCore &core)
+std::unique_ptr<ASTToolAction> CreateElaborateAnalyzePass(VrtlmodCore &core)
 {
-    return newGeneratorFrontendActionFactory<vrtlmod::ParserAction<vrtlmod::passes::AnalyzePass>>(core);
+    return newParserActionFactory<
+        vrtlmod::ParserAction<vrtlmod::passes::ElaboratePass, vrtlmod::passes::AnalyzePass>>(core);
 }
 
-std::unique_ptr<clang::tooling::ToolAction> CreateSignalDeclPass(VrtlmodCore &core)
+std::unique_ptr<ASTToolAction> CreateSignalDeclPass(VrtlmodCore &core)
 {
-    return newGeneratorFrontendActionFactory<vrtlmod::ParserAction<vrtlmod::passes::SignalDeclRewriter>>(core);
+    return newParserActionFactory<vrtlmod::ParserAction<vrtlmod::passes::SignalDeclRewriter>>(core);
 }
 
-std::unique_ptr<clang::tooling::ToolAction> CreateInjectionPass(VrtlmodCore &core)
+std::unique_ptr<ASTToolAction> CreateInjectionPass(VrtlmodCore &core)
 {
-    return newGeneratorFrontendActionFactory<vrtlmod::ParserAction<vrtlmod::passes::InjectionRewriter>>(core);
+    return newParserActionFactory<vrtlmod::ParserAction<vrtlmod::passes::InjectionRewriter>>(core);
 }
 
 } // namespace vrtlmod
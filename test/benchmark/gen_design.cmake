@@ -0,0 +1,120 @@
+####################################################################################################
+# Copyright 2022 Chair of EDA, Technical University of Munich
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+####################################################################################################
+
+####################################################################################################
+# vrtlmod_generate_design(<file> TOP <name> MODULES <N> INSTANCES <M> REGISTERS <K>)
+#
+# Writes a synthetic SystemVerilog design to <file>: N module types with K registers each, instantiated
+# M times each by the top module <name>. The registers cycle through the VRTL types vrtlmod has to
+# handle: CData, VlWide, and 1D (VlWide), 2D and 3D unpacked arrays. All registers feed the module
+# output and all instances are chained, so Verilator keeps everything.
+function(vrtlmod_generate_design FILE)
+    cmake_parse_arguments(ARG "" "TOP;MODULES;INSTANCES;REGISTERS" "" ${ARGN})
+    foreach(arg MODULES INSTANCES REGISTERS)
+        if(NOT ARG_${arg} GREATER 0)
+            message(FATAL_ERROR "vrtlmod_generate_design: ${arg} has to be greater than 0")
+        endif()
+    endforeach()
+    math(EXPR LAST_MODULE "${ARG_MODULES} - 1")
+    math(EXPR LAST_INSTANCE "${ARG_INSTANCES} - 1")
+    math(EXPR LAST_REGISTER "${ARG_REGISTERS} - 1")
+
+    set(SV "// generated by vrtlmod_generate_design(): ${ARG_MODULES} modules, ${ARG_INSTANCES} instances each, ${ARG_REGISTERS} registers each\n\n")
+    foreach(m RANGE ${LAST_MODULE})
+        set(DECLS "")
+        set(RESETS "")
+        set(UPDATES "")
+        set(OUTS "")
+        foreach(r RANGE ${LAST_REGISTER})
+            math(EXPR TYPE "(${r} + ${m}) % 5")
+            set(R "r${r}_q")
+            if(TYPE EQUAL 0) # CData
+                string(APPEND DECLS "  logic [7:0] ${R};\n")
+                string(APPEND RESETS "      ${R} <= 8'b0;\n")
+                string(APPEND UPDATES "      ${R} <= ${R} + {7'b0, d};\n")
+                list(APPEND OUTS "${R}[0]")
+            elseif(TYPE EQUAL 1) # VlWide
+                string(APPEND DECLS "  logic [95:0] ${R};\n")
+                string(APPEND RESETS "      ${R} <= 96'b0;\n")
+                string(APPEND UPDATES "      ${R} <= {${R}[94:0], d};\n")
+                list(APPEND OUTS "${R}[95]")
+            elseif(TYPE EQUAL 2) # 1D unpacked VlWide
+                string(APPEND DECLS "  logic [64:0] ${R} [2];\n")
+                string(APPEND UPDATES "      ${R}[0] <= {${R}[0][63:0], d};\n      ${R}[1] <= ${R}[0];\n")
+                list(APPEND OUTS "${R}[1][64]")
+            elseif(TYPE EQUAL 3) # 2D unpacked SData
+                string(APPEND DECLS "  logic [15:0] ${R} [2][2];\n")
+                string(APPEND UPDATES "      ${R}[0][0] <= ${R}[0][0] + {15'b0, d};\n      ${R}[1][1] <= ${R}[0][0];\n")
+                list(APPEND OUTS "${R}[1][1][0]")
+            else() # 3D unpacked CData
+                string(APPEND DECLS "  logic [2:0] ${R} [2][2][2];\n")
+                string(APPEND UPDATES "      ${R}[0][0][0] <= {${R}[0][0][0][1:0], d};\n      ${R}[1][1][1] <= ${R}[0][0][0];\n")
+                list(APPEND OUTS "${R}[1][1][1][2]")
+            endif()
+        endforeach()
+        list(JOIN OUTS " ^ " OUT_EXPR)
+        string(APPEND SV
+            "module ${ARG_TOP}_mod${m}\n"
+            "  (\n"
+            "    input logic clk, reset,\n"
+            "    input logic d,\n"
+            "    output logic q\n"
+            "  );\n"
+            "${DECLS}\n"
+            "  assign q = ${OUT_EXPR};\n\n"
+            "  always_ff @(posedge clk)\n"
+            "    if(reset) begin\n"
+            "${RESETS}"
+            "    end else begin\n"
+            "${UPDATES}"
+            "    end\n"
+            "endmodule\n\n"
+        )
+    endforeach()
+
+    set(WIRES "")
+    set(CELLS "")
+    set(PREV "a")
+    foreach(m RANGE ${LAST_MODULE})
+        foreach(i RANGE ${LAST_INSTANCE})
+            set(W "w_${m}_${i}")
+            string(APPEND WIRES "  logic ${W};\n")
+            string(APPEND CELLS "  ${ARG_TOP}_mod${m} u_${m}_${i}(.clk(clk), .reset(reset), .d(${PREV}), .q(${W}));\n")
+            set(PREV "${W}")
+        endforeach()
+    endforeach()
+    string(APPEND SV
+        "module ${ARG_TOP}\n"
+        "  (\n"
+        "    input logic clk, reset,\n"
+        "    input logic a,\n"
+        "    output logic o\n"
+        "  );\n"
+        "${WIRES}\n"
+        "${CELLS}\n"
+        "  assign o = ${PREV};\n"
+        "endmodule\n"
+    )
+
+    # keep the file (and its timestamp) if the design did not change
+    if(EXISTS ${FILE})
+        file(READ ${FILE} OLD)
+        if(OLD STREQUAL SV)
+            return()
+        endif()
+    endif()
+    file(WRITE ${FILE} "${SV}")
+endfunction()
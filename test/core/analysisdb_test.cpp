@@ -0,0 +1,182 @@
+/*
+ * Copyright 2022 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file analysisdb_test.cpp
+/// @brief Serializes an analysis XML and reads the database back through analysisdb::View
+/// @details Writes the database to argv[1] if given, for the python loader test (analysisdb_test.py)
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/analysisdb.hpp"
+
+#include <pugixml.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const char *xml = R"(<?xml version="1.0"?>
+<vrtlmod_xml version="test">
+  <top>
+    <cell id="TOP" type="Vtop" decl_loc="f0:l10:c5" />
+  </top>
+  <modules>
+    <module id="Vtop" decl_loc="f0:l3:c1">
+      <in id="clk" bases="[CData]" dim="[0:0]" cxx_type="CData" bits="1" decl_loc="f0:l12:c9" />
+      <cell id="sub" type="Vsub" decl_loc="f0:l20:c5" />
+      <var id="mem" bases="[VlUnpacked, VlWide]" dim="[4, 69:0]" cxx_type="VlUnpacked&lt;VlWide&lt;3&gt;, 4&gt;" bits="280" decl_loc="f0:l30:c9" inj_loc="[f1:l40:c3, f1:l41:c7]" />
+    </module>
+    <module id="Vsub" decl_loc="f1:l2:c1">
+      <out id="q" bases="[IData]" dim="[31:0]" cxx_type="IData" bits="32" decl_loc="f1:l5:c9" inj_loc="[f1:l50:c3]" />
+      <var id="bad" bases="[]" dim="[x:0]" cxx_type="" bits="0" decl_loc="f9:l1:c1" />
+    </module>
+  </modules>
+  <files>
+    <file id="f0" path="obj_dir/Vtop.h" />
+    <file id="f1" path="obj_dir/Vtop.cpp" />
+  </files>
+</vrtlmod_xml>
+)";
+
+int failures = 0;
+
+template <typename T> void expect(const char *what, const T &got, const T &expected)
+{
+    if (!(got == expected))
+    {
+        std::cerr << "FAILED " << what << ": got [" << got << "], expected [" << expected << "]" << std::endl;
+        ++failures;
+    }
+}
+
+void expect_location(const char *what, const vrtlmod::analysisdb::Location &got, uint32_t file, uint32_t line,
+                     uint32_t column)
+{
+    std::stringstream x, y;
+    x << got.file_ << ":" << got.line_ << ":" << got.column_;
+    y << file << ":" << line << ":" << column;
+    expect(what, x.str(), y.str());
+}
+
+uint32_t read_le(const std::string &data, size_t offset)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data.data() + offset);
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    using namespace vrtlmod::analysisdb;
+
+    pugi::xml_document doc;
+    if (!doc.load_string(xml))
+    {
+        std::cerr << "FAILED to parse the test XML" << std::endl;
+        return 1;
+    }
+    std::string db = serialize(doc.child("vrtlmod_xml"));
+    if (argc > 1)
+    {
+        std::ofstream(argv[1], std::ios::binary) << db;
+    }
+
+    // the file is little-endian independent of the host
+    expect("version (little-endian)", read_le(db, sizeof(MAGIC)), VERSION);
+    expect("top cell (little-endian)", read_le(db, sizeof(MAGIC) + 4), uint32_t(0));
+
+    // View reads the records in place and needs an aligned buffer
+    std::vector<uint64_t> mapped((db.size() + 7) / 8);
+    std::memcpy(mapped.data(), db.data(), db.size());
+    View view(mapped.data());
+    if (!host_is_little_endian())
+    {
+        expect("valid on a big-endian host", view.valid(), false);
+        std::cout << "big-endian host, skipped reading through View" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+    expect("valid", view.valid(), true);
+    for (uint32_t s = STRINGS; s < SECTION_COUNT; ++s)
+    {
+        expect("section alignment", view.header().sections_[s].offset_ % 8, uint32_t(0));
+    }
+
+    expect("files", view.count(FILES), uint32_t(2));
+    auto files = view.records<FileRecord>(FILES);
+    expect("file id", files[1].id_, uint32_t(1));
+    expect("file path", std::string(view.string(files[1].path_)), std::string("obj_dir/Vtop.cpp"));
+
+    expect("modules", view.count(MODULES), uint32_t(2));
+    auto modules = view.records<ModuleRecord>(MODULES);
+    expect("module id", std::string(view.string(modules[0].id_)), std::string("Vtop"));
+    expect_location("module decl", modules[0].decl_, 0, 3, 1);
+    expect("module cells", modules[0].cell_count_, uint32_t(1));
+    expect("module variables", modules[0].variable_count_, uint32_t(2));
+    expect("second module variables", modules[1].first_variable_, uint32_t(2));
+
+    expect("cells", view.count(CELLS), uint32_t(2));
+    auto cells = view.records<CellRecord>(CELLS);
+    expect("top cell", std::string(view.string(cells[view.header().top_cell_].id_)), std::string("TOP"));
+    expect("top cell parent", cells[0].parent_, NONE);
+    expect("top cell module", cells[0].module_, uint32_t(0));
+    expect("sub cell type", std::string(view.string(cells[1].type_)), std::string("Vsub"));
+    expect("sub cell module", cells[1].module_, uint32_t(1));
+    expect("sub cell parent", cells[1].parent_, uint32_t(0));
+    expect_location("sub cell decl", cells[1].decl_, 0, 20, 5);
+
+    expect("variables", view.count(VARIABLES), uint32_t(4));
+    auto variables = view.records<VariableRecord>(VARIABLES);
+    auto dimensions = view.records<DimensionRecord>(DIMENSIONS);
+    auto locations = view.records<Location>(LOCATIONS);
+
+    const VariableRecord &clk = variables[0];
+    expect("clk kind", clk.kind_, uint32_t(IN));
+    expect("clk bits", clk.bits_, int32_t(1));
+    expect("clk injectable", clk.inj_loc_count_, uint32_t(0));
+
+    const VariableRecord &mem = variables[1];
+    expect("mem id", std::string(view.string(mem.id_)), std::string("mem"));
+    expect("mem kind", mem.kind_, uint32_t(VAR));
+    expect("mem bits", mem.bits_, int32_t(280));
+    expect("mem bases", std::string(view.string(mem.bases_)), std::string("VlUnpacked, VlWide"));
+    expect("mem cxx_type", std::string(view.string(mem.cxx_type_)), std::string("VlUnpacked<VlWide<3>, 4>"));
+    expect("mem dimensions", mem.dimension_count_, uint32_t(2));
+    expect("mem unpacked msb", dimensions[mem.first_dimension_].msb_, int32_t(3));
+    expect("mem unpacked lsb", dimensions[mem.first_dimension_].lsb_, int32_t(0));
+    expect("mem packed msb", dimensions[mem.first_dimension_ + 1].msb_, int32_t(69));
+    expect_location("mem decl", mem.decl_, 0, 30, 9);
+    expect("mem injection locations", mem.inj_loc_count_, uint32_t(2));
+    expect_location("mem second injection", locations[mem.first_inj_loc_ + 1], 1, 41, 7);
+
+    const VariableRecord &q = variables[2];
+    expect("q kind", q.kind_, uint32_t(OUT));
+    expect("q module", q.module_, uint32_t(1));
+    expect_location("q injection", locations[q.first_inj_loc_], 1, 50, 3);
+
+    const VariableRecord &bad = variables[3];
+    expect("bad dimension msb", dimensions[bad.first_dimension_].msb_, int32_t(-1));
+    expect("bad decl file", bad.decl_.file_, NONE);
+
+    std::cout << "analysis database of " << db.size() << " bytes, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
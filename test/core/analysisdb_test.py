@@ -0,0 +1,107 @@
+####################################################################################################
+# Copyright 2022 Chair of EDA, Technical University of Munich
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+####################################################################################################
+
+####################################################################################################
+# python3 analysisdb_test.py <generated *_vrtlmod_td_module.py> <database>
+#
+# Reads the database written by analysisdb_test.cpp back through the AnalysisDB loader of a
+# generated python module and checks the records of the test XML in analysisdb_test.cpp.
+import importlib.util
+import sys
+
+spec = importlib.util.spec_from_file_location("td_module", sys.argv[1])
+td_module = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(td_module)
+AnalysisDB = td_module.AnalysisDB
+
+failures = 0
+
+
+def expect(what, got, expected):
+    global failures
+    if got != expected:
+        print("FAILED " + what + ": got [" + str(got) + "], expected [" + str(expected) + "]", file=sys.stderr)
+        failures += 1
+
+
+db = AnalysisDB(sys.argv[2])
+
+expect("files", db.count(AnalysisDB.FILES), 2)
+file_id, file_path = db.record(AnalysisDB.FILES, 1)
+expect("file id", file_id, 1)
+expect("file path", db.string(file_path), "obj_dir/Vtop.cpp")
+
+# (id, decl file, decl line, decl column, first cell, cell count, first variable, variable count)
+modules = list(db.records(AnalysisDB.MODULES))
+expect("modules", len(modules), 2)
+expect("module id", db.string(modules[0][0]), "Vtop")
+expect("module decl", modules[0][1:4], (0, 3, 1))
+expect("module cells", modules[0][5], 1)
+expect("module variables", modules[0][7], 2)
+expect("second module variables", modules[1][6], 2)
+
+# (id, type, module, parent, decl file, decl line, decl column)
+cells = list(db.records(AnalysisDB.CELLS))
+expect("cells", len(cells), 2)
+expect("top cell", db.string(cells[db.top_cell_][0]), "TOP")
+expect("top cell parent", cells[0][3], AnalysisDB.NONE)
+expect("top cell module", cells[0][2], 0)
+expect("sub cell type", db.string(cells[1][1]), "Vsub")
+expect("sub cell module", cells[1][2], 1)
+expect("sub cell parent", cells[1][3], 0)
+expect("sub cell decl", cells[1][4:7], (0, 20, 5))
+
+# (id, module, kind, bits, cxx type, bases, first dimension, dimension count, decl file, decl line, decl column,
+#  first injection location, injection location count)
+variables = list(db.records(AnalysisDB.VARIABLES))
+dimensions = list(db.records(AnalysisDB.DIMENSIONS))
+expect("variables", len(variables), 4)
+
+clk = variables[0]
+expect("clk kind", clk[2], 0)
+expect("clk bits", clk[3], 1)
+expect("clk injectable", clk[12], 0)
+
+mem = variables[1]
+expect("mem id", db.string(mem[0]), "mem")
+expect("mem kind", mem[2], 3)
+expect("mem bits", mem[3], 280)
+expect("mem bases", db.string(mem[5]), "VlUnpacked, VlWide")
+expect("mem cxx_type", db.string(mem[4]), "VlUnpacked<VlWide<3>, 4>")
+expect("mem dimensions", mem[7], 2)
+expect("mem unpacked", dimensions[mem[6]], (3, 0))
+expect("mem packed msb", dimensions[mem[6] + 1][0], 69)
+expect("mem decl", mem[8:11], (0, 30, 9))
+expect("mem injection locations", mem[12], 2)
+expect("mem second injection", db.record(AnalysisDB.LOCATIONS, mem[11] + 1), (1, 41, 7))
+
+q = variables[2]
+expect("q kind", q[2], 1)
+expect("q module", q[1], 1)
+expect("q injection", db.record(AnalysisDB.LOCATIONS, q[11]), (1, 50, 3))
+
+bad = variables[3]
+expect("bad dimension msb", dimensions[bad[6]][0], -1)
+expect("bad decl file", bad[8], AnalysisDB.NONE)
+
+try:
+    db.record(AnalysisDB.VARIABLES, 4)
+    expect("record out of range raises IndexError", False, True)
+except IndexError:
+    pass
+
+print("analysis database read back by python, " + str(failures) + " failures")
+sys.exit(0 if failures == 0 else 1)
@@ -0,0 +1,320 @@
+/*
+ * Copyright 2022 Chair of EDA, Technical University of Munich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	 http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file typeparser_test.cpp
+/// @brief Compares VlTypeParser with the regex-based declaration parsing it replaced
+////////////////////////////////////////////////////////////////////////////////
+
+#include "vrtlmod/core/typeparser.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The declaration parsing of VrtlmodCore::add_variable() before VlTypeParser, kept as reference
+vrtlmod::VlTypeInfo regex_parse(const std::string &id, const std::string &type, const std::string &decl_source_code_text)
+{
+    std::regex ctype_portdecl("/\\*VL_IN[1-9]*\\*/|/\\*VL_OUT[1-9]*\\*/|/\\*VL_INOUT[1-9]*\\*/");
+    std::regex wctype_portdecl("/\\*VL_INW*\\*/|/\\*VL_OUTW*\\*/|/\\*VL_INOUTW*\\*/");
+    std::regex sctype_portdecl("sc_in<|sc_out<");
+
+    std::string var_type = "undef";
+    std::string msb = "msb";
+    std::string lsb = "lsb";
+    std::vector<std::pair<std::string, std::string>> unpacked;
+
+    auto unpack = [&unpacked](std::string &packed_str, const std::regex &break_regex) {
+        auto open_templ = packed_str.find("<");
+        auto close_templ = packed_str.rfind(">");
+        auto comma = packed_str.rfind(",");
+        std::string outer_dim = packed_str.substr(comma + 1, close_templ - (comma + 1));
+        auto base = packed_str.substr(0, open_templ);
+        packed_str = packed_str.substr(open_templ + 1, comma - (open_templ + 1));
+        unpacked.push_back(std::make_pair<>(std::string(base), std::string(outer_dim)));
+        bool cont = std::regex_search(packed_str, break_regex);
+        if (!cont)
+        {
+            unpacked.push_back(std::make_pair<>(std::string(packed_str), std::string(outer_dim)));
+        }
+        return cont;
+    };
+
+    if (std::regex_search(decl_source_code_text, ctype_portdecl))
+    {
+        auto first_col = decl_source_code_text.rfind(id) + id.length() + 1;
+        auto second_col = decl_source_code_text.find(",", first_col + 1);
+        msb = decl_source_code_text.substr(first_col, second_col - first_col);
+        auto last_brace = decl_source_code_text.rfind(")*/;");
+        ++second_col;
+
+        lsb = decl_source_code_text.substr(second_col, last_brace - second_col);
+        var_type = std::regex_search(decl_source_code_text, std::regex("/\\*VL_IN[1-9]*\\*/")) ? "in" : "out";
+        auto cxx_base_type_str = decl_source_code_text.substr(0, decl_source_code_text.find(id) - 1);
+        unpacked.push_back(std::make_pair<>(std::string(cxx_base_type_str), std::string("0")));
+    }
+    else if (std::regex_search(decl_source_code_text, wctype_portdecl))
+    {
+        auto first_col = decl_source_code_text.rfind(id) + id.length() + 1;
+        auto second_col = decl_source_code_text.find(",", first_col + 1);
+        auto third_col = decl_source_code_text.find(",", second_col + 1);
+        msb = decl_source_code_text.substr(first_col, second_col - first_col);
+        ++second_col;
+        lsb = decl_source_code_text.substr(second_col, third_col - second_col);
+        var_type = std::regex_search(decl_source_code_text, std::regex("/\\*VL_INW*\\*/")) ? "in" : "out";
+        auto cxx_base_type_str = decl_source_code_text.substr(0, decl_source_code_text.find(id) - 1);
+#if VRTLMOD_VERILATOR_VERSION <= 4204
+        auto openbrace = decl_source_code_text.find('[');
+        auto closebrace = decl_source_code_text.find(']');
+        cxx_base_type_str += decl_source_code_text.substr(openbrace, closebrace - openbrace + 1);
+#endif
+        unpacked.push_back(std::make_pair<>(std::string(cxx_base_type_str), std::string("0")));
+    }
+    else if (std::regex_search(decl_source_code_text, sctype_portdecl))
+    {
+        var_type = std::regex_search(decl_source_code_text, std::regex("sc_in<")) ? "in" : "out";
+        auto cxx_base_type_str = decl_source_code_text.substr(0, decl_source_code_text.find(id));
+
+        std::string search = decl_source_code_text;
+        auto open_templ = search.find("<");
+        auto close_templ = search.rfind(">");
+        auto inner_str = search.substr(open_templ + 1, close_templ - (open_templ + 1));
+
+        if (std::regex_search(inner_str, std::regex("^sc_bv<")))
+        {
+            auto open_templ = inner_str.find("<");
+            auto close_templ = inner_str.rfind(">");
+            msb = std::to_string(std::stoi(inner_str.substr(open_templ + 1, close_templ - (open_templ + 1))) - 1);
+            lsb = "0";
+        }
+        else if (std::regex_search(inner_str, std::regex("int64_")))
+        {
+            msb = "63";
+            lsb = "0";
+        }
+        else if (std::regex_search(inner_str, std::regex("int32_")))
+        {
+            msb = "31";
+            lsb = "0";
+        }
+        else if (std::regex_search(inner_str, std::regex("int16_")))
+        {
+            msb = "15";
+            lsb = "0";
+        }
+        else if (std::regex_search(inner_str, std::regex("int8_")))
+        {
+            msb = "7";
+            lsb = "0";
+        }
+        else if (std::regex_search(inner_str, std::regex("^bool|^Bool_|^Bool")))
+        {
+            msb = "0";
+            lsb = "0";
+        }
+        else
+        {
+            msb = "undef";
+            lsb = "undef";
+        }
+
+        unpacked.push_back(std::make_pair<>(std::string(cxx_base_type_str), std::string("0")));
+    }
+    else // something else aka must be a signal
+    {
+        if (std::regex_search(type, std::regex("^VlUnpacked<")))
+        {
+            bool still_going = false;
+            std::string search = decl_source_code_text;
+            do
+            {
+                still_going = unpack(search, std::regex("^VlUnpacked<"));
+            } while (still_going);
+        }
+        else // packed signal
+        {
+            auto close_space = decl_source_code_text.find(" ");
+            unpacked.push_back(std::make_pair<>(decl_source_code_text.substr(0, close_space), std::string("0")));
+        }
+
+        std::string zerodim_typestr = unpacked.back().first;
+        auto open_comm = zerodim_typestr.find("/*");
+        auto colon_comm = zerodim_typestr.find(":");
+        auto close_comm = zerodim_typestr.rfind("*/");
+        msb = zerodim_typestr.substr(open_comm + 2, colon_comm - (open_comm + 2));
+        lsb = zerodim_typestr.substr(colon_comm + 1, close_comm - (colon_comm + 1));
+        var_type = "var";
+    }
+
+    unpacked.back().second = msb + ":" + lsb;
+    unpacked.back().first = unpacked.back().first.substr(0, unpacked.back().first.find("/*"));
+    std::string bases, dim;
+    long bits = 1;
+    bool first_base = true;
+    for (auto &pair_ : unpacked)
+    {
+        pair_.first.erase(
+            std::remove_if(pair_.first.begin(), pair_.first.end(), [](unsigned char x) { return std::isspace(x); }),
+            pair_.first.end());
+        pair_.second.erase(
+            std::remove_if(pair_.second.begin(), pair_.second.end(), [](unsigned char x) { return std::isspace(x); }),
+            pair_.second.end());
+
+        if (first_base)
+        {
+            first_base = false;
+            bases = pair_.first;
+            dim = pair_.second;
+        }
+        else
+        {
+            bases = bases + ", " + pair_.first;
+            dim = dim + ", " + pair_.second;
+        }
+
+        try
+        {
+            bits *= (pair_.second.find(":") == std::string::npos)
+                        ? boost::lexical_cast<int>(pair_.second)
+                        : ((boost::lexical_cast<int>(msb) + 1) - boost::lexical_cast<int>(lsb));
+        }
+        catch (boost::bad_lexical_cast)
+        {
+            bits *= 0;
+        }
+    }
+
+    vrtlmod::VlTypeInfo ret;
+    ret.var_type_ = var_type;
+    ret.bases_ = bases;
+    ret.dim_ = dim;
+    ret.bits_ = bits;
+    return ret;
+}
+
+struct Case
+{
+    const char *id_;
+    const char *type_;
+    const char *decl_;
+    long bits_; ///< expected total bits, as a sanity check of the reference itself
+};
+
+// declarations as vrtlmod sees them after the macro pass, i.e., with the port macros commented out
+const Case cases[] = {
+    // ctype ports
+    { "clk", "CData", "CData/*0:0*/ clk /*VL_IN8*//*(clk,0,0)*/;", 1 },
+    { "result", "SData", "SData/*15:0*/ result /*VL_OUT16*//*(result,15,0)*/;", 16 },
+    { "io", "IData", "IData/*31:0*/ io /*VL_INOUT*//*(io,31,0)*/;", 32 },
+    { "q", "QData", "QData/*40:1*/ q /*VL_OUT64*//*(q,40,1)*/;", 40 },
+    // wide ports
+#if VRTLMOD_VERILATOR_VERSION <= 4204
+    { "data", "WData [3]", "WData/*95:0*/ data[3] /*VL_INW*//*(data,95,0,3)*/;", 96 },
+    { "wout", "WData [3]", "WData/*64:0*/ wout[3] /*VL_OUTW*//*(wout,64,0,3)*/;", 65 },
+#else
+    { "data", "VlWide<3>", "VlWide<3>/*95:0*/ data /*VL_INW*//*(data,95,0,3)*/;", 96 },
+    { "wout", "VlWide<3>", "VlWide<3>/*64:0*/ wout /*VL_OUTW*//*(wout,64,0,3)*/;", 65 },
+#endif
+    // SystemC ports
+    { "clk", "sc_in<bool>", "sc_in<bool> clk;", 1 },
+    { "res", "sc_out<uint32_t>", "sc_out<uint32_t> res;", 32 },
+    { "wide", "sc_in<sc_bv<70> >", "sc_in<sc_bv<70> > wide;", 70 },
+    { "q", "sc_in<vluint64_t>", "sc_in<vluint64_t> q;", 64 },
+    { "h", "sc_out<uint16_t>", "sc_out<uint16_t> h;", 16 },
+    { "b", "sc_out<uint8_t>", "sc_out<uint8_t> b;", 8 },
+    { "x", "sc_out<foo>", "sc_out<foo> x;", 0 },
+    // packed signals
+    { "fiapp__DOT__reg_q", "CData", "CData/*7:0*/ fiapp__DOT__reg_q;", 8 },
+    { "other_q", "CData", "CData/*7:0*/ other_q;", 8 },
+    { "Data", "CData", "CData/*7:0*/ Data;", 8 },
+    { "s", "SData", "SData/*12:3*/ s;", 10 },
+    { "q", "QData", "QData/*63:0*/ q;", 64 },
+    { "w", "VlWide<3>", "VlWide<3>/*95:0*/ w;", 96 },
+    { "bad", "CData", "CData/*x:0*/ bad;", 0 },
+    // unpacked signals
+    { "mem", "VlUnpacked<CData, 4>", "VlUnpacked<CData/*7:0*/, 4> mem;", 32 },
+    { "m2", "VlUnpacked<VlUnpacked<SData, 2>, 3>", "VlUnpacked<VlUnpacked<SData/*15:0*/, 2>, 3> m2;", 96 },
+    { "m3", "VlUnpacked<VlUnpacked<VlUnpacked<CData, 2>, 2>, 2>",
+      "VlUnpacked<VlUnpacked<VlUnpacked<CData/*2:0*/, 2>, 2>, 2> m3;", 24 },
+    { "uw", "VlUnpacked<VlWide<3>, 2>", "VlUnpacked<VlWide<3>/*64:0*/, 2> uw;", 130 },
+    { "um", "VlUnpacked<VlUnpacked<SData, 2>, 3>", "VlUnpacked<VlUnpacked<SData/*15:0*/, 2>, 3> um;", 96 },
+};
+
+int failures = 0;
+
+void check(bool cond, const Case &c, const char *what, const std::string &got, const std::string &expected)
+{
+    if (!cond)
+    {
+        ++failures;
+        std::cerr << "FAILED [" << c.decl_ << "] " << what << ": got [" << got << "], expected [" << expected << "]"
+                  << std::endl;
+    }
+}
+
+void compare(const Case &c, const vrtlmod::VlTypeInfo &got)
+{
+    vrtlmod::VlTypeInfo ref = regex_parse(c.id_, c.type_, c.decl_);
+    check(got.var_type_ == ref.var_type_, c, "var_type_", got.var_type_, ref.var_type_);
+    check(got.bases_ == ref.bases_, c, "bases_", got.bases_, ref.bases_);
+    check(got.dim_ == ref.dim_, c, "dim_", got.dim_, ref.dim_);
+    check(got.bits_ == ref.bits_, c, "bits_", std::to_string(got.bits_), std::to_string(ref.bits_));
+    check(std::max(ref.bits_, 0l) == c.bits_, c, "reference bits_", std::to_string(ref.bits_),
+          std::to_string(c.bits_));
+}
+
+} // namespace
+
+int main(void)
+{
+    vrtlmod::VlTypeParser parser;
+    for (auto const &c : cases)
+    {
+        compare(c, parser.parse(c.id_, c.type_, c.decl_));
+    }
+    // all signals of one type share a cache entry: "other_q", "Data" and "um" are answered from the cache
+    size_t first_hits = parser.get_hits();
+    if (first_hits != 3)
+    {
+        ++failures;
+        std::cerr << "FAILED cache hits of the first pass: " << first_hits << ", expected 3" << std::endl;
+    }
+
+    // the second pass is answered from the cache entirely and still has to match the reference
+    size_t misses = parser.get_misses();
+    for (auto const &c : cases)
+    {
+        compare(c, parser.parse(c.id_, c.type_, c.decl_));
+    }
+    if (parser.get_misses() != misses || parser.get_hits() != first_hits + sizeof(cases) / sizeof(cases[0]))
+    {
+        ++failures;
+        std::cerr << "FAILED second pass was not answered from the cache" << std::endl;
+    }
+
+    std::cout << (sizeof(cases) / sizeof(cases[0])) << " declarations, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
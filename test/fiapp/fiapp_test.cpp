@@ -40,6 +40,8 @@ int main(int argc, char *argv[])
     VfiappVRTLmodAPI gFault;
     VfiappVRTLmodAPI gRef;
     VfiappVRTLmodAPIDifferential gDiff(gFault, gRef);
+    // golden model: same instrumented classes, not connected to any API, so it never injects
+    Vfiapp gGolden("golden");
 
     bool testreturn = true;
 
@@ -48,21 +50,27 @@ int main(int argc, char *argv[])
         {
             gFault.vrtl_.eval();
             gRef.vrtl_.eval();
+            gGolden.eval();
             gFault.vrtl_.clk = 1;
             gRef.vrtl_.clk = 1;
+            gGolden.clk = 1;
             gFault.vrtl_.eval();
             gRef.vrtl_.eval();
+            gGolden.eval();
             gFault.vrtl_.clk = 0;
             gRef.vrtl_.clk = 0;
+            gGolden.clk = 0;
         }
     };
 
     auto reset = [&](void) -> void {
         gFault.vrtl_.reset = 1;
         gRef.vrtl_.reset = 1;
+        gGolden.reset = 1;
         clockspin(3);
         gFault.vrtl_.reset = 0;
         gRef.vrtl_.reset = 0;
+        gGolden.reset = 0;
     };
     auto check_diff = [&](vrtlfi::td::TDentry const *target) -> int {
         vrtlfi::td::TDentry const *diff_target = nullptr;
@@ -121,12 +129,25 @@ int main(int argc, char *argv[])
             }
         }
 
+        // the targets armed in gFault must neither inject into the reference nor into the golden model
+        bool golden_ok = gRef.vrtl_.o1 == gGolden.o1 && gRef.vrtl_.o2 == gGolden.o2 && gRef.vrtl_.o3 == gGolden.o3;
+        for (int i = 0; i < 3; ++i)
+        {
+            golden_ok &= gRef.vrtl_.o4[i] == gGolden.o4[i];
+        }
+        if (!golden_ok)
+        {
+            std::cout << "|-> \033[0;31mFailed\033[0m reference and golden model differ" << std::endl;
+            ret |= 0x10;
+        }
+
         return ret;
     };
 
     // VRTL warm-up
     gFault.vrtl_.eval();
     gRef.vrtl_.eval();
+    gGolden.eval();
 
     reset();
 